@@ -1,5 +1,5 @@
 # Qt 多平台行事曆整合工具
-QT += core gui network sql widgets
+QT += core gui network sql widgets concurrent
 
 # NetworkAuth module (Qt6::NetworkAuth) is REQUIRED for this project
 # The code uses OAuth2 authentication which depends on NetworkAuth headers
@@ -40,19 +40,58 @@ SOURCES += \
     src/main.cpp \
     src/core/CalendarEvent.cpp \
     src/core/CalendarManager.cpp \
+    src/core/ConflictDetector.cpp \
+    src/core/EventMerger.cpp \
+    src/core/EventStore.cpp \
+    src/core/EventTimeIndex.cpp \
+    src/core/FreeBusyEngine.cpp \
+    src/core/MeetingSlotFinder.cpp \
+    src/core/RecurrenceExpander.cpp \
+    src/core/StringPool.cpp \
+    src/core/TrigramIndex.cpp \
+    src/adapters/CalendarAdapter.cpp \
+    src/adapters/EventPageCache.cpp \
     src/adapters/GoogleCalendarAdapter.cpp \
+    src/adapters/JsonStreamParser.cpp \
     src/adapters/OutlookCalendarAdapter.cpp \
+    src/adapters/RequestBatcher.cpp \
+    src/adapters/RequestScheduler.cpp \
+    src/adapters/ResponseCache.cpp \
+    src/adapters/ResponseParseStage.cpp \
     src/storage/DatabaseManager.cpp \
+    src/storage/DatabaseWriter.cpp \
+    src/ui/EventFilterProxyModel.cpp \
+    src/ui/EventListModel.cpp \
+    src/ui/EventSearchController.cpp \
     src/ui/MainWindow.cpp
 
 # 標頭檔案
 HEADERS += \
     src/core/CalendarEvent.h \
     src/core/CalendarManager.h \
+    src/core/ConflictDetector.h \
+    src/core/EventMerger.h \
+    src/core/EventStore.h \
+    src/core/EventTimeIndex.h \
+    src/core/FreeBusyEngine.h \
+    src/core/MeetingSlotFinder.h \
+    src/core/RecurrenceExpander.h \
+    src/core/StringPool.h \
+    src/core/TrigramIndex.h \
     src/adapters/CalendarAdapter.h \
+    src/adapters/EventPageCache.h \
     src/adapters/GoogleCalendarAdapter.h \
+    src/adapters/JsonStreamParser.h \
     src/adapters/OutlookCalendarAdapter.h \
+    src/adapters/RequestBatcher.h \
+    src/adapters/RequestScheduler.h \
+    src/adapters/ResponseCache.h \
+    src/adapters/ResponseParseStage.h \
     src/storage/DatabaseManager.h \
+    src/storage/DatabaseWriter.h \
+    src/ui/EventFilterProxyModel.h \
+    src/ui/EventListModel.h \
+    src/ui/EventSearchController.h \
     src/ui/MainWindow.h
 
 # Include 目錄
@@ -0,0 +1,41 @@
+#include "CalendarAdapter.h"
+#include <QCryptographicHash>
+#include <QNetworkReply>
+
+CalendarAdapter::CalendarAdapter(QObject* parent)
+    : QObject(parent)
+{
+}
+
+void CalendarAdapter::setPageSize(int pageSize) {
+    m_pageSize = qMax(1, pageSize);
+}
+
+void CalendarAdapter::setOwner(const QString& platformName, const QString& ownerId, const QString& accessToken) {
+    m_ownerId = ownerId;
+    
+    // 回應快取以已認證的使用者區分，同一個 OAuth 用戶端下的不同帳號不會共用快取；
+    // 取不到帳號時改以存取權杖區分，只在這次登入內共用
+    const QString identity = !m_ownerId.isEmpty()
+        ? m_ownerId.toLower()
+        : "token-" + QString::fromLatin1(QCryptographicHash::hash(accessToken.toUtf8(), QCryptographicHash::Sha1).toHex());
+    m_pageCache.responseCache().setAccount(platformName + ":" + identity);
+}
+
+void CalendarAdapter::trackTransfer(QNetworkReply* reply) {
+    // downloadProgress 回報的是解壓前的位元組數，累計為線路上的傳輸量
+    reply->setProperty("trackTransfer", true);
+    connect(reply, &QNetworkReply::downloadProgress, this, [this, reply](qint64 received, qint64) {
+        m_transferStats.wireBytes += received - reply->property("wireBytes").toLongLong();
+        reply->setProperty("wireBytes", received);
+    });
+}
+
+QByteArray CalendarAdapter::readChunk(QNetworkReply* reply) {
+    // 讀出的片段為解壓後的內容
+    const QByteArray chunk = reply->readAll();
+    if (reply->property("trackTransfer").toBool()) {
+        m_transferStats.decodedBytes += chunk.size();
+    }
+    return chunk;
+}
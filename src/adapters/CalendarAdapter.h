@@ -2,14 +2,18 @@
 
 #include <QObject>
 #include <QList>
+#include <QHash>
 #include "core/CalendarEvent.h"
+#include "EventPageCache.h"
+
+class QNetworkReply;
 
 // 抽象基類 - 所有平台適配器的介面
 class CalendarAdapter : public QObject {
     Q_OBJECT
     
 public:
-    explicit CalendarAdapter(QObject* parent = nullptr) : QObject(parent) {}
+    explicit CalendarAdapter(QObject* parent = nullptr);
     virtual ~CalendarAdapter() = default;
     
     // 認證
@@ -21,10 +25,78 @@ public:
     // 獲取任務
     virtual void fetchTasks() = 0;
     
+    // 平台類型
+    virtual Platform platform() const = 0;
+    
+    // 增量同步：syncStates 以行事曆識別對應先前保存的同步狀態（Google syncToken / Graph deltaLink），
+    // 沒有狀態的行事曆執行完整同步；變更以 eventChangesReceived 回報，每個行事曆結束時發出新的同步狀態
+    virtual void syncEvents(const QDateTime& start, const QDateTime& end, const QHash<QString, QString>& syncStates) = 0;
+    
+    // 增量同步涵蓋的行事曆識別，每個行事曆各保存一筆同步狀態
+    virtual QStringList syncCalendarIds() const = 0;
+    
+    // 已認證的使用者（Google 帳號 email / Graph userPrincipalName），用於標記事件的擁有者；
+    // 認證完成前為空
+    QString ownerId() const { return m_ownerId; }
+    
+    // 每頁事件數；每頁解析完成即以 eventsReceived / eventChangesReceived 送出
+    void setPageSize(int pageSize);
+    int pageSize() const { return m_pageSize; }
+    
+    // 只要求解析會用到的欄位（Google fields= / Graph $select）；關閉後可比較傳輸量
+    void setFieldProjection(bool enabled) { m_fieldProjection = enabled; }
+    bool fieldProjection() const { return m_fieldProjection; }
+    
+    // 最近一次 fetchEvents 的傳輸量：wireBytes 為線路上（壓縮後）的位元組數，decodedBytes 為解壓後
+    struct TransferStats {
+        qint64 wireBytes = 0;
+        qint64 decodedBytes = 0;
+    };
+    TransferStats transferStats() const { return m_transferStats; }
+    
+    // 事件分頁的回應快取（ETag / Last-Modified 重新驗證）
+    ResponseCache& responseCache() { return m_pageCache.responseCache(); }
+    
+    // 啟用後先以記憶體中的快取結果送出事件，再於背景重新驗證；有變更時再送出新的內容
+    void setStaleWhileRevalidate(bool enabled) { m_pageCache.setStaleWhileRevalidate(enabled); }
+    bool staleWhileRevalidate() const { return m_pageCache.staleWhileRevalidate(); }
+    
 signals:
     void authenticated();
     void authenticationFailed(const QString& error);
     void eventsReceived(const QList<CalendarEvent>& events);
     void tasksReceived(const QList<Task>& tasks);
+    void eventChangesReceived(const QList<CalendarEvent>& changed, const QStringList& removedIds);
+    void syncStateUpdated(const QString& calendarId, const QString& syncState);
     void errorOccurred(const QString& error);
+    
+    // 一次 fetchEvents / syncEvents 的所有分頁都已送出；發生錯誤時不會發出
+    void fetchCompleted(int eventCount);
+    
+protected:
+    // QNetworkAccessManager 會自動送出 Accept-Encoding: gzip 並透明解壓；
+    // Google API 另需 User-Agent 含有 "gzip" 才會壓縮回應
+    static constexpr const char* kUserAgent = "CalendarIntegration/1.0 (gzip)";
+    
+    // OAuth 用戶端識別，用於請求排程的令牌桶
+    void setAccount(const QString& account) { m_account = account; }
+    const QString& account() const { return m_account; }
+    
+    // 認證後取得的使用者；回應快取同時改以該使用者區分
+    void setOwner(const QString& platformName, const QString& ownerId, const QString& accessToken);
+    
+    EventPageCache& pageCache() { return m_pageCache; }
+    
+    // 事件分頁的傳輸量統計
+    void resetTransferStats() { m_transferStats = TransferStats(); }
+    void trackTransfer(QNetworkReply* reply);
+    QByteArray readChunk(QNetworkReply* reply);
+    
+private:
+    QString m_account;
+    QString m_ownerId;
+    int m_pageSize = 250;
+    bool m_fieldProjection = true;
+    TransferStats m_transferStats;
+    EventPageCache m_pageCache;
 };
@@ -0,0 +1,103 @@
+#include "EventPageCache.h"
+#include <QNetworkReply>
+#include <QNetworkRequest>
+
+void EventPageCache::begin() {
+    m_staleEventIds.clear();
+    m_freshEventIds.clear();
+}
+
+void EventPageCache::prepare(QNetworkRequest& request, const QUrl& url, EventPageJob* page) {
+    page->cacheKey = m_cache.key(url);
+    m_cache.prepare(request, page->cacheKey);
+}
+
+QSharedPointer<const EventPageJob> EventPageCache::serveStale(EventPageJob* page) {
+    if (!m_staleWhileRevalidate) {
+        return {};
+    }
+    const QSharedPointer<const EventPageJob> cached = m_cache.parsed(page->cacheKey).staticCast<const EventPageJob>();
+    if (!cached) {
+        return {};
+    }
+    
+    // 重新驗證的結果之後照常交付；未變更時不再重複送出
+    page->servedStale = true;
+    m_cache.recordStaleServed();
+    for (const CalendarEvent& event : cached->events) {
+        m_staleEventIds.insert(event.id);
+    }
+    return cached;
+}
+
+void EventPageCache::close(QNetworkReply* reply, const QByteArray& rest, StreamParseJob* page,
+                           const QString& errorPrefix, QObject* context, StreamParseJob::Completion done) {
+    if (reply->error() != QNetworkReply::NoError) {
+        m_cache.discard(reply);
+        page->closeWithError(QString("%1: %2").arg(errorPrefix, reply->errorString()), context, std::move(done));
+        return;
+    }
+    
+    m_cache.write(reply, rest);
+    m_cache.commit(reply);
+    page->close(rest, context, std::move(done));
+}
+
+bool EventPageCache::reuse(QNetworkReply* reply, EventPageJob* page, QObject* context,
+                           StreamParseJob::Completion done) {
+    m_cache.discard(reply);
+    m_cache.recordHit();
+    
+    const QSharedPointer<const EventPageJob> cached = m_cache.parsed(page->cacheKey).staticCast<const EventPageJob>();
+    if (cached) {
+        // 內容未變更：沿用先前的解析結果，完全略過解析
+        page->events = cached->events;
+        page->removedIds = cached->removedIds;
+        page->nextPage = cached->nextPage;
+        page->syncState = cached->syncState;
+        page->fromCache = true;
+        return true;
+    }
+    
+    // 記憶體中沒有解析結果（例如重新啟動後），改為解析磁碟上的內容；下一頁由欄位回呼送出
+    const QByteArray body = m_cache.body(page->cacheKey);
+    if (body.isNull()) {
+        page->closeWithError("獲取事件失敗: 回應快取內容遺失", context, std::move(done));
+    } else {
+        page->close(body, context, std::move(done));
+    }
+    return false;
+}
+
+bool EventPageCache::deliver(const QSharedPointer<StreamParseJob>& job) {
+    const EventPageJob* page = static_cast<const EventPageJob*>(job.data());
+    if (m_staleWhileRevalidate) {
+        for (const CalendarEvent& event : page->events) {
+            m_freshEventIds.insert(event.id);
+        }
+    }
+    
+    // 新解析的內容保留在記憶體中，下次 304 時直接沿用
+    if (!page->cacheKey.isEmpty() && !page->fromCache) {
+        m_cache.storeParsed(page->cacheKey, job);
+    }
+    return !(page->fromCache && page->servedStale);
+}
+
+void EventPageCache::fail(const EventPageJob* page) {
+    if (!page->cacheKey.isEmpty()) {
+        m_cache.remove(page->cacheKey);
+    }
+    begin();
+}
+
+QStringList EventPageCache::finish() {
+    QStringList removed;
+    for (const QString& id : std::as_const(m_staleEventIds)) {
+        if (!m_freshEventIds.contains(id)) {
+            removed.append(id);
+        }
+    }
+    begin();
+    return removed;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "ResponseCache.h"
+#include "ResponseParseStage.h"
+#include "core/CalendarEvent.h"
+#include <QSet>
+#include <QStringList>
+
+class QNetworkReply;
+class QNetworkRequest;
+
+// 一頁事件回應的解析結果。nextPage 為 Google 的 nextPageToken 或 Graph 的 nextLink，
+// 空字串表示最後一頁；syncState 為最後一頁帶回的同步狀態（nextSyncToken / deltaLink）
+struct EventPageJob : StreamParseJob {
+    using StreamParseJob::StreamParseJob;
+    QList<CalendarEvent> events;
+    QStringList removedIds;
+    QString nextPage;
+    QString syncState;
+};
+
+// 事件分頁的回應快取流程，Google 與 Outlook 適配器共用：請求帶上條件式標頭，200 的內容
+// 邊解析邊寫入快取，304 時沿用記憶體中的解析結果（沒有時解析磁碟上的內容）。
+// stale-while-revalidate 啟用時先送出上次的結果，所有分頁重新驗證後找出已不存在的事件。
+class EventPageCache {
+public:
+    ResponseCache& responseCache() { return m_cache; }
+    
+    void setStaleWhileRevalidate(bool enabled) { m_staleWhileRevalidate = enabled; }
+    bool staleWhileRevalidate() const { return m_staleWhileRevalidate; }
+    
+    // 新的一次取得開始，清除先行送出事件的記錄
+    void begin();
+    
+    // 送出請求前呼叫：有快取內容時加上條件式標頭
+    void prepare(QNetworkRequest& request, const QUrl& url, EventPageJob* page);
+    
+    // 回應的內容寫入快取（只有 track 過的回應才會寫入）
+    void track(QNetworkReply* reply, const EventPageJob* page) { m_cache.track(reply, page->cacheKey); }
+    void write(QNetworkReply* reply, const QByteArray& chunk) { m_cache.write(reply, chunk); }
+    void discard(QNetworkReply* reply) { m_cache.discard(reply); }
+    
+    // stale-while-revalidate：回傳上次的解析結果，由呼叫端先行送出；沒有時回傳空指標
+    QSharedPointer<const EventPageJob> serveStale(EventPageJob* page);
+    
+    // 回應結束（304 以外）：錯誤時捨棄寫入中的內容並以錯誤結束 page，
+    // 否則剩餘內容寫入快取後交給 page 解析；完成時在 context 所在執行緒呼叫 done
+    void close(QNetworkReply* reply, const QByteArray& rest, StreamParseJob* page, const QString& errorPrefix,
+               QObject* context, StreamParseJob::Completion done);
+    
+    // 304：記憶體中有解析結果時複製到 page 並回傳 true，由呼叫端送出下一頁並交付；
+    // 否則解析磁碟上的內容，完成時呼叫 done
+    bool reuse(QNetworkReply* reply, EventPageJob* page, QObject* context, StreamParseJob::Completion done);
+    
+    // 分頁依序交付時呼叫：新解析的內容保留供下次 304 沿用。
+    // 回傳 false 表示重新驗證確認未變更，相同的內容已先行送出
+    bool deliver(const QSharedPointer<StreamParseJob>& job);
+    
+    // 分頁失敗：無法解析的快取內容不再使用
+    void fail(const EventPageJob* page);
+    
+    // 所有分頁都已交付：回傳先行送出、但重新驗證後已不存在的事件（分頁間移動的事件不受影響）
+    QStringList finish();
+    
+private:
+    ResponseCache m_cache;
+    bool m_staleWhileRevalidate = false;
+    QSet<QString> m_staleEventIds;
+    QSet<QString> m_freshEventIds;
+};
@@ -6,22 +6,37 @@
 #include <QNetworkRequest>
 #include <QNetworkReply>
 #include <QUrlQuery>
+#include <QTimeZone>
 #include <QDateTime>
 #include <QAbstractOAuth>
 
+// 只取回 parseEventItem / parseTaskItem 會用到的欄位，以及分頁與同步所需的權杖
+static const char* const kEventFields =
+    "nextPageToken,nextSyncToken,items(id,status,summary,description,location,start,end,"
+    "attendees/email,recurrence,iCalUID,recurringEventId,originalStartTime)";
+static const char* const kTaskFields = "nextPageToken,items(id,title,notes,due,status)";
+
 GoogleCalendarAdapter::GoogleCalendarAdapter(QObject* parent)
     : CalendarAdapter(parent)
     , m_networkManager(new QNetworkAccessManager(this))
     , m_oauth(nullptr)
     , m_replyHandler(nullptr)
+    , m_calendarIds({"primary"})
 {
+    m_batcher = new RequestBatcher(RequestBatcher::Format::Google, m_networkManager, this);
+    m_batcher->setUserAgent(kUserAgent);
 }
 
-GoogleCalendarAdapter::~GoogleCalendarAdapter() = default;
+GoogleCalendarAdapter::~GoogleCalendarAdapter() {
+    // 工作者的回呼會呼叫 parseEventItem，需等解析結束
+    ResponseParseStage::waitForDone();
+}
 
 void GoogleCalendarAdapter::setCredentials(const QString& clientId, const QString& clientSecret) {
     m_clientId = clientId;
     m_clientSecret = clientSecret;
+    setAccount("google:" + clientId);
+    m_batcher->setSchedulerBucket(account() + "/calendar");
     setupOAuth();
 }
 
@@ -78,10 +93,46 @@ void GoogleCalendarAdapter::authenticate() {
 
 void GoogleCalendarAdapter::onAuthenticationGranted() {
     m_accessToken = m_oauth->token();
+    m_batcher->setAccessToken(m_accessToken);
     qDebug() << "Google Calendar 認證成功！";
+    
+    // primary 行事曆的 id 即為帳號 email；取得後事件才能標記擁有者
+    QUrl url("https://www.googleapis.com/calendar/v3/calendars/primary");
+    url.setQuery("fields=id");
+    schedule("calendar", createRequest(url), [this](QNetworkReply* reply) {
+        connect(reply, &QNetworkReply::finished, this, &GoogleCalendarAdapter::onIdentityReplyFinished);
+    });
+}
+
+void GoogleCalendarAdapter::onIdentityReplyFinished() {
+    QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
+    if (!reply) return;
+    
+    if (reply->error() == QNetworkReply::NoError) {
+        setOwner("google", QJsonDocument::fromJson(reply->readAll()).object()["id"].toString(), m_accessToken);
+        qDebug() << "Google Calendar 帳號:" << ownerId();
+    } else {
+        // 取不到帳號時仍可使用，只是 primary 的事件不標記擁有者
+        qDebug() << "取得 Google Calendar 帳號失敗:" << reply->errorString();
+        setOwner("google", QString(), m_accessToken);
+    }
+    
+    reply->deleteLater();
     emit authenticated();
 }
 
+QString GoogleCalendarAdapter::ownerIdOf(const QString& calendarId) const {
+    // 其他行事曆（共用、訂閱）以行事曆 id 作為擁有者
+    return calendarId == "primary" ? ownerId() : calendarId;
+}
+
+QString GoogleCalendarAdapter::calendarIdOf(const QUrl& url) {
+    // .../calendar/v3/calendars/<calendarId>/events
+    const QStringList segments = url.path().split('/');
+    const int index = segments.indexOf("calendars");
+    return index >= 0 ? segments.value(index + 1) : QString();
+}
+
 void GoogleCalendarAdapter::onAuthenticationError(const QString& error, const QString& errorDescription) {
     QString errorMsg = QString("認證錯誤: %1 - %2").arg(error, errorDescription);
     qDebug() << errorMsg;
@@ -89,44 +140,321 @@ void GoogleCalendarAdapter::onAuthenticationError(const QString& error, const QS
 }
 
 void GoogleCalendarAdapter::fetchEvents(const QDateTime& start, const QDateTime& end) {
+    startEvents(start, end, {}, false);
+}
+
+void GoogleCalendarAdapter::syncEvents(const QDateTime& start, const QDateTime& end,
+                                       const QHash<QString, QString>& syncStates) {
+    startEvents(start, end, syncStates, true);
+}
+
+void GoogleCalendarAdapter::startEvents(const QDateTime& start, const QDateTime& end,
+                                        const QHash<QString, QString>& syncStates, bool syncing) {
     if (m_accessToken.isEmpty()) {
         emit errorOccurred("尚未認證，請先呼叫 authenticate()");
         return;
     }
     
-    // 構建 Google Calendar API 請求
-    QUrl url("https://www.googleapis.com/calendar/v3/calendars/primary/events");
+    m_syncing = syncing;
+    m_syncStart = start;
+    m_syncEnd = end;
+    m_eventPages.reset();
+    pageCache().begin();
+    resetTransferStats();
+    m_batcher->cancelAll();
+    m_fetchedEventCount = 0;
+    m_activeCalendars = m_calendarIds.size();
+    
+    // 只有一個行事曆時直接串流；多個行事曆的第一頁打包成一個批次請求，之後的分頁各自串流
+    for (const QString& calendarId : m_calendarIds) {
+        const QUrl url = eventsUrl(calendarId, syncStates.value(calendarId));
+        if (m_calendarIds.size() == 1) {
+            requestEventsPage(url);
+        } else {
+            requestBatchedEventsPage(url);
+        }
+    }
+}
+
+QUrl GoogleCalendarAdapter::eventsUrl(const QString& calendarId, const QString& syncToken) const {
+    QUrl url(QString("https://www.googleapis.com/calendar/v3/calendars/%1/events")
+             .arg(QString::fromUtf8(QUrl::toPercentEncoding(calendarId))));
+    
+    // syncToken 不可與 timeMin/timeMax/orderBy 並用；沒有同步狀態時以時間範圍取得，同步時即建立基準
     QUrlQuery query;
-    query.addQueryItem("timeMin", start.toUTC().toString(Qt::ISODate));
-    query.addQueryItem("timeMax", end.toUTC().toString(Qt::ISODate));
-    query.addQueryItem("singleEvents", "true");
-    query.addQueryItem("orderBy", "startTime");
+    if (syncToken.isEmpty()) {
+        query.addQueryItem("timeMin", m_syncStart.toUTC().toString(Qt::ISODate));
+        query.addQueryItem("timeMax", m_syncEnd.toUTC().toString(Qt::ISODate));
+    } else {
+        query.addQueryItem("syncToken", syncToken);
+    }
+    if (m_expandRecurrencesLocally) {
+        // 只取回系列主事件與例外，由 CalendarManager 在本地展開
+        query.addQueryItem("singleEvents", "false");
+    } else {
+        query.addQueryItem("singleEvents", "true");
+        if (!m_syncing) {
+            query.addQueryItem("orderBy", "startTime");
+        }
+    }
+    query.addQueryItem("maxResults", QString::number(pageSize()));
+    if (fieldProjection()) {
+        query.addQueryItem("fields", kEventFields);
+    }
     url.setQuery(query);
+    return url;
+}
+
+QUrl GoogleCalendarAdapter::nextPageUrl(const QUrl& url, const QString& pageToken) {
+    QUrl next = url;
+    QUrlQuery query(next);
+    query.removeAllQueryItems("pageToken");
+    query.addQueryItem("pageToken", pageToken);
+    next.setQuery(query);
+    return next;
+}
+
+void GoogleCalendarAdapter::requestEventsPage(const QUrl& url) {
+    QNetworkRequest request = createRequest(url);
+    
+    // 有快取內容時送出條件式請求，未變更的分頁回應 304；帶 syncToken 的請求每次都不同，不必快取
+    const PagePtr page = createEventsPage(url);
+    const bool cacheable = !QUrlQuery(url).hasQueryItem("syncToken");
+    if (cacheable) {
+        pageCache().prepare(request, url, page.data());
+    }
+    const int generation = page->generation;
+    schedule("calendar", request, [this, page, cacheable](QNetworkReply* reply) {
+        if (cacheable) {
+            pageCache().track(reply, page.data());
+        }
+        trackTransfer(reply);
+        attachPage(reply, page);
+        reply->setProperty("fetchGeneration", page->generation);
+        connect(reply, &QNetworkReply::finished, this, &GoogleCalendarAdapter::onEventsReplyFinished);
+    }, [this, generation]() {
+        return generation != m_eventPages.generation();
+    });
+    
+    // stale-while-revalidate：先送出上次的結果，重新驗證的結果之後經由 deliverEventsPage 送出
+    if (cacheable) {
+        if (const auto stale = pageCache().serveStale(page.data())) {
+            emit eventsReceived(stale->events);
+        }
+    }
+}
+
+void GoogleCalendarAdapter::requestBatchedEventsPage(const QUrl& url) {
+    const PagePtr page = createEventsPage(url);
+    m_batcher->enqueue(url, [this, page](const RequestBatcher::Response& response) {
+        if (page->generation != m_eventPages.generation()) {
+            return;
+        }
+        if (response.status == 410) {
+            restartCalendar(page);
+            return;
+        }
+        
+        const auto done = [this, page]() {
+            deliverEventsPage(page);
+        };
+        if (!response.error.isEmpty()) {
+            page->closeWithError(QString("獲取事件失敗: %1").arg(response.error), this, done);
+        } else {
+            page->close(response.body, this, done);
+        }
+    });
+}
+
+GoogleCalendarAdapter::PagePtr GoogleCalendarAdapter::createEventsPage(const QUrl& url) {
+    const PagePtr page = createPage(m_syncing ? "同步" : "事件");
+    m_eventPages.enqueue(page.data());
     
+    // 以下回呼在工作者執行緒執行，只寫入本頁的欄位
+    PendingPage* target = page.data();
+    target->calendarId = calendarIdOf(url);
+    const int generation = page->generation;
+    const bool keepCancelledInstances = m_expandRecurrencesLocally;
+    const QString ownerId = ownerIdOf(target->calendarId);
+    target->parser.setItemHandler([this, target, keepCancelledInstances, ownerId](const QJsonObject& item) {
+        // 增量同步回報的已刪除事件只記錄 id；系列中被取消的單次實例，保留為取消的例外以抑制本地展開
+        if (item["status"].toString() == "cancelled" &&
+            !(keepCancelledInstances && item.contains("recurringEventId"))) {
+            target->removedIds.append(item["id"].toString());
+        } else {
+            target->events.append(parseEventItem(item, ownerId));
+        }
+    });
+    // nextPageToken 通常位於 items 之前，一讀到就送出下一頁請求，讓下一頁的傳輸與本頁的解析重疊
+    target->parser.setFieldHandler([this, target, url, generation](const QString& key, const QJsonValue& value) {
+        if (key == "nextSyncToken") {
+            target->syncState = value.toString();
+            return;
+        }
+        if (key != "nextPageToken") {
+            return;
+        }
+        target->nextPage = value.toString();
+        const QUrl next = nextPageUrl(url, target->nextPage);
+        QMetaObject::invokeMethod(this, [this, next, generation]() {
+            if (generation == m_eventPages.generation()) {
+                requestEventsPage(next);
+            }
+        }, Qt::QueuedConnection);
+    });
+    return page;
+}
+
+void GoogleCalendarAdapter::restartCalendar(const PagePtr& page) {
+    // syncToken 已失效：清除該行事曆的同步狀態並重新建立基準，其他行事曆不受影響；
+    // 失效的分頁不解析，直接標記後交付，讓排在後面的分頁照常送出
+    qDebug() << "Google syncToken 已失效，重新完整同步行事曆" << page->calendarId;
+    emit syncStateUpdated(page->calendarId, QString());
+    page->restarted = true;
+    requestEventsPage(eventsUrl(page->calendarId, QString()));
+    deliverEventsPage(page);
+}
+
+QNetworkRequest GoogleCalendarAdapter::createRequest(const QUrl& url) const {
     QNetworkRequest request(url);
     request.setRawHeader("Authorization", QString("Bearer %1").arg(m_accessToken).toUtf8());
     request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+    request.setHeader(QNetworkRequest::UserAgentHeader, kUserAgent);
+    return request;
+}
+
+GoogleCalendarAdapter::PagePtr GoogleCalendarAdapter::createPage(const QString& label) const {
+    const PagePtr page = PagePtr::create();
+    page->label = "Google " + label;
+    return page;
+}
+
+void GoogleCalendarAdapter::attachPage(QNetworkReply* reply, const PagePtr& page) {
+    m_pendingPages.insert(reply, page);
+    connect(reply, &QNetworkReply::readyRead, this, &GoogleCalendarAdapter::onReplyReadyRead);
+}
+
+void GoogleCalendarAdapter::schedule(const QString& api, const QNetworkRequest& request,
+                                     std::function<void(QNetworkReply*)> attach, std::function<bool()> cancelled) {
+    // 經由共用的排程器送出；暫時失敗時排程器捨棄舊回應並以新的回應重新 attach
+    RequestScheduler::Request scheduled;
+    scheduled.bucket = account() + "/" + api;
+    scheduled.context = this;
+    scheduled.send = [this, request]() {
+        return m_networkManager->get(request);
+    };
+    scheduled.attach = std::move(attach);
+    scheduled.detach = [this](QNetworkReply* reply) {
+        m_pendingPages.remove(reply);
+        pageCache().discard(reply);
+    };
+    scheduled.cancelled = std::move(cancelled);
+    RequestScheduler::instance()->submit(scheduled);
+}
+
+void GoogleCalendarAdapter::onReplyReadyRead() {
+    QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
+    if (!reply) return;
     
-    QNetworkReply* reply = m_networkManager->get(request);
-    connect(reply, &QNetworkReply::finished, this, &GoogleCalendarAdapter::onEventsReplyFinished);
+    // 已被新的 fetchEvents 取代的分頁不必再解析
+    const QVariant generation = reply->property("fetchGeneration");
+    if (generation.isValid() && generation.toInt() != m_eventPages.generation()) {
+        return;
+    }
+    
+    // 錯誤回應的內容不解析，由 finished 處理
+    if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 200) {
+        return;
+    }
+    
+    const PagePtr page = m_pendingPages.value(reply);
+    if (page) {
+        const QByteArray chunk = readChunk(reply);
+        pageCache().write(reply, chunk);
+        page->append(chunk);
+    }
+}
+
+void GoogleCalendarAdapter::closePage(QNetworkReply* reply, const PagePtr& page, const QString& errorPrefix,
+                                      StreamParseJob::Completion done) {
+    const QByteArray rest = reply->error() == QNetworkReply::NoError ? readChunk(reply) : QByteArray();
+    pageCache().close(reply, rest, page.data(), errorPrefix, this, std::move(done));
 }
 
 void GoogleCalendarAdapter::onEventsReplyFinished() {
     QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
     if (!reply) return;
+    reply->deleteLater();
     
-    if (reply->error() == QNetworkReply::NoError) {
-        QByteArray data = reply->readAll();
-        QList<CalendarEvent> events = parseEventsJson(data);
-        qDebug() << "獲取到" << events.size() << "個 Google Calendar 事件";
-        emit eventsReceived(events);
-    } else {
-        QString error = QString("獲取事件失敗: %1").arg(reply->errorString());
-        qDebug() << error;
-        emit errorOccurred(error);
+    // 已開始新的 fetchEvents / syncEvents，舊的分頁不再處理
+    const PagePtr page = m_pendingPages.take(reply);
+    if (!page || page->generation != m_eventPages.generation()) {
+        pageCache().discard(reply);
+        return;
     }
     
-    reply->deleteLater();
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (status == 410) {
+        pageCache().discard(reply);
+        restartCalendar(page);
+        return;
+    }
+    
+    const auto done = [this, page]() {
+        deliverEventsPage(page);
+    };
+    if (status != 304) {
+        closePage(reply, page, "獲取事件失敗", done);
+    } else if (pageCache().reuse(reply, page.data(), this, done)) {
+        if (!page->nextPage.isEmpty()) {
+            requestEventsPage(nextPageUrl(reply->url(), page->nextPage));
+        }
+        deliverEventsPage(page);
+    }
+}
+
+void GoogleCalendarAdapter::deliverEventsPage(const PagePtr& page) {
+    // 分頁可能不依序解析完成，依請求順序送出
+    const QList<QSharedPointer<StreamParseJob>> ready = m_eventPages.complete(page);
+    for (const QSharedPointer<StreamParseJob>& job : ready) {
+        const PendingPage* parsed = static_cast<const PendingPage*>(job.data());
+        if (parsed->restarted) {
+            continue;
+        }
+        if (!parsed->error.isEmpty()) {
+            qDebug() << parsed->error;
+            pageCache().fail(parsed);
+            emit errorOccurred(parsed->error);
+            m_eventPages.reset();
+            return;
+        }
+        
+        m_fetchedEventCount += parsed->events.size();
+        if (pageCache().deliver(job)) {
+            if (m_syncing) {
+                emit eventChangesReceived(parsed->events, parsed->removedIds);
+            } else {
+                emit eventsReceived(parsed->events);
+            }
+        }
+        
+        // 每個行事曆的最後一頁帶回該行事曆的同步狀態；全部行事曆都完成才算取得結束
+        if (!parsed->nextPage.isEmpty()) {
+            continue;
+        }
+        if (m_syncing && !parsed->syncState.isEmpty()) {
+            emit syncStateUpdated(parsed->calendarId, parsed->syncState);
+        }
+        if (--m_activeCalendars == 0) {
+            qDebug() << (m_syncing ? "同步到" : "獲取到") << m_fetchedEventCount << "個 Google Calendar 事件";
+            const QStringList removed = pageCache().finish();
+            if (!removed.isEmpty()) {
+                qDebug() << "重新驗證後有" << removed.size() << "個先行送出的快取事件已不存在";
+                emit eventChangesReceived({}, removed);
+            }
+            emit fetchCompleted(m_fetchedEventCount);
+        }
+    }
 }
 
 void GoogleCalendarAdapter::fetchTasks() {
@@ -137,119 +465,127 @@ void GoogleCalendarAdapter::fetchTasks() {
     
     // 構建 Google Tasks API 請求
     QUrl url("https://tasks.googleapis.com/tasks/v1/lists/@default/tasks");
+    if (fieldProjection()) {
+        url.setQuery(QString("fields=%1").arg(kTaskFields));
+    }
     
-    QNetworkRequest request(url);
-    request.setRawHeader("Authorization", QString("Bearer %1").arg(m_accessToken).toUtf8());
-    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+    QNetworkRequest request = createRequest(url);
     
-    QNetworkReply* reply = m_networkManager->get(request);
-    connect(reply, &QNetworkReply::finished, this, &GoogleCalendarAdapter::onTasksReplyFinished);
+    const PagePtr page = createPage("任務");
+    PendingPage* target = page.data();
+    target->parser.setItemHandler([this, target](const QJsonObject& item) {
+        target->tasks.append(parseTaskItem(item));
+    });
+    schedule("tasks", request, [this, page](QNetworkReply* reply) {
+        attachPage(reply, page);
+        connect(reply, &QNetworkReply::finished, this, &GoogleCalendarAdapter::onTasksReplyFinished);
+    });
 }
 
 void GoogleCalendarAdapter::onTasksReplyFinished() {
     QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
     if (!reply) return;
     
-    if (reply->error() == QNetworkReply::NoError) {
-        QByteArray data = reply->readAll();
-        QList<Task> tasks = parseTasksJson(data);
-        qDebug() << "獲取到" << tasks.size() << "個 Google Tasks 任務";
-        emit tasksReceived(tasks);
-    } else {
-        QString error = QString("獲取任務失敗: %1").arg(reply->errorString());
-        qDebug() << error;
-        emit errorOccurred(error);
+    const PagePtr page = m_pendingPages.take(reply);
+    if (page) {
+        closePage(reply, page, "獲取任務失敗", [this, page]() {
+            if (!page->error.isEmpty()) {
+                qDebug() << page->error;
+                emit errorOccurred(page->error);
+                return;
+            }
+            qDebug() << "獲取到" << page->tasks.size() << "個 Google Tasks 任務";
+            emit tasksReceived(page->tasks);
+        });
     }
     
     reply->deleteLater();
 }
 
-QList<CalendarEvent> GoogleCalendarAdapter::parseEventsJson(const QByteArray& json) {
-    QList<CalendarEvent> events;
+CalendarEvent GoogleCalendarAdapter::parseEventItem(const QJsonObject& item, const QString& ownerId) const {
+    CalendarEvent event;
+    event.id = item["id"].toString();
+    event.ownerId = ownerId;
+    event.title = item["summary"].toString();
+    event.description = item["description"].toString();
+    event.location = item["location"].toString();
+    event.platform = Platform::Google;
     
-    QJsonDocument doc = QJsonDocument::fromJson(json);
-    if (!doc.isObject()) return events;
+    // 解析開始時間
+    QJsonObject startObj = item["start"].toObject();
+    if (startObj.contains("dateTime")) {
+        event.startTime = QDateTime::fromString(startObj["dateTime"].toString(), Qt::ISODate);
+        event.isAllDay = false;
+    } else if (startObj.contains("date")) {
+        QDate date = QDate::fromString(startObj["date"].toString(), Qt::ISODate);
+        event.startTime = QDateTime(date, QTime(0, 0));
+        event.isAllDay = true;
+    }
     
-    QJsonObject root = doc.object();
-    QJsonArray items = root["items"].toArray();
+    // 解析結束時間
+    QJsonObject endObj = item["end"].toObject();
+    if (endObj.contains("dateTime")) {
+        event.endTime = QDateTime::fromString(endObj["dateTime"].toString(), Qt::ISODate);
+    } else if (endObj.contains("date")) {
+        QDate date = QDate::fromString(endObj["date"].toString(), Qt::ISODate);
+        event.endTime = QDateTime(date, QTime(23, 59, 59));
+    }
     
-    for (const QJsonValue& value : items) {
-        QJsonObject item = value.toObject();
-        
-        CalendarEvent event;
-        event.id = item["id"].toString();
-        event.title = item["summary"].toString();
-        event.description = item["description"].toString();
-        event.location = item["location"].toString();
-        event.platform = Platform::Google;
-        
-        // 解析開始時間
-        QJsonObject startObj = item["start"].toObject();
-        if (startObj.contains("dateTime")) {
-            event.startTime = QDateTime::fromString(startObj["dateTime"].toString(), Qt::ISODate);
-            event.isAllDay = false;
-        } else if (startObj.contains("date")) {
-            QDate date = QDate::fromString(startObj["date"].toString(), Qt::ISODate);
-            event.startTime = QDateTime(date, QTime(0, 0));
-            event.isAllDay = true;
-        }
-        
-        // 解析結束時間
-        QJsonObject endObj = item["end"].toObject();
-        if (endObj.contains("dateTime")) {
-            event.endTime = QDateTime::fromString(endObj["dateTime"].toString(), Qt::ISODate);
-        } else if (endObj.contains("date")) {
-            QDate date = QDate::fromString(endObj["date"].toString(), Qt::ISODate);
-            event.endTime = QDateTime(date, QTime(23, 59, 59));
-        }
-        
-        // 解析參與者
-        QJsonArray attendees = item["attendees"].toArray();
-        for (const QJsonValue& attendee : attendees) {
-            event.attendees.append(attendee.toObject()["email"].toString());
-        }
-        
-        // 解析重複規則
-        QJsonArray recurrence = item["recurrence"].toArray();
-        if (!recurrence.isEmpty()) {
-            event.recurrenceRule = recurrence[0].toString();
-        }
-        
-        events.append(event);
+    // dateTime 只帶固定時差；改用 start.timeZone 的 IANA 時區，重複事件跨越日光節約時間時才展開正確
+    const QTimeZone zone(startObj["timeZone"].toString().toUtf8());
+    if (!event.isAllDay && zone.isValid()) {
+        event.startTime = event.startTime.toTimeZone(zone);
+        event.endTime = event.endTime.toTimeZone(zone);
     }
     
-    return events;
-}
-
-QList<Task> GoogleCalendarAdapter::parseTasksJson(const QByteArray& json) {
-    QList<Task> tasks;
+    // 解析參與者
+    QJsonArray attendees = item["attendees"].toArray();
+    for (const QJsonValue& attendee : attendees) {
+        event.attendees.append(attendee.toObject()["email"].toString());
+    }
     
-    QJsonDocument doc = QJsonDocument::fromJson(json);
-    if (!doc.isObject()) return tasks;
+    // 解析重複規則（RRULE、EXDATE、RDATE 可能各佔一行）
+    QStringList recurrenceLines;
+    const QJsonArray recurrence = item["recurrence"].toArray();
+    for (const QJsonValue& line : recurrence) {
+        recurrenceLines.append(line.toString());
+    }
+    event.recurrenceRule = recurrenceLines.join('\n');
     
-    QJsonObject root = doc.object();
-    QJsonArray items = root["items"].toArray();
+    // 跨平台比對同一會議
+    event.iCalUid = item["iCalUID"].toString();
     
-    for (const QJsonValue& value : items) {
-        QJsonObject item = value.toObject();
-        
-        Task task;
-        task.id = item["id"].toString();
-        task.title = item["title"].toString();
-        task.description = item["notes"].toString();
-        task.platform = Platform::Google;
-        
-        // 解析到期日期
-        if (item.contains("due")) {
-            task.dueDate = QDateTime::fromString(item["due"].toString(), Qt::ISODate);
+    // 系列中的實例或例外
+    event.seriesMasterId = item["recurringEventId"].toString();
+    const QJsonObject originalObj = item["originalStartTime"].toObject();
+    if (originalObj.contains("dateTime")) {
+        event.originalStartTime = QDateTime::fromString(originalObj["dateTime"].toString(), Qt::ISODate);
+        if (zone.isValid()) {
+            event.originalStartTime = event.originalStartTime.toTimeZone(zone);
         }
-        
-        // 解析完成狀態
-        QString status = item["status"].toString();
-        task.isCompleted = (status == "completed");
-        
-        tasks.append(task);
+    } else if (originalObj.contains("date")) {
+        event.originalStartTime = QDateTime(QDate::fromString(originalObj["date"].toString(), Qt::ISODate), QTime(0, 0));
+    }
+    event.isCancelled = item["status"].toString() == "cancelled";
+    
+    return event;
+}
+
+Task GoogleCalendarAdapter::parseTaskItem(const QJsonObject& item) const {
+    Task task;
+    task.id = item["id"].toString();
+    task.title = item["title"].toString();
+    task.description = item["notes"].toString();
+    task.platform = Platform::Google;
+    
+    // 解析到期日期
+    if (item.contains("due")) {
+        task.dueDate = QDateTime::fromString(item["due"].toString(), Qt::ISODate);
     }
     
-    return tasks;
+    // 解析完成狀態
+    QString status = item["status"].toString();
+    task.isCompleted = (status == "completed");
+    
+    return task;
 }
@@ -1,10 +1,16 @@
 #pragma once
 
 #include "CalendarAdapter.h"
+#include "RequestBatcher.h"
+#include "RequestScheduler.h"
+#include "ResponseParseStage.h"
 #include <QNetworkAccessManager>
 #include <QOAuthHttpServerReplyHandler>
 #include <QOAuth2AuthorizationCodeFlow>
 #include <QDesktopServices>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QHash>
 
 // Google Calendar 適配器
 class GoogleCalendarAdapter : public CalendarAdapter {
@@ -17,26 +23,82 @@ public:
     // 設定 OAuth 2.0 憑證
     void setCredentials(const QString& clientId, const QString& clientSecret);
     
+    // 啟用後以 singleEvents=false 取回系列主事件，改由本地展開重複事件
+    void setExpandRecurrencesLocally(bool enabled) { m_expandRecurrencesLocally = enabled; }
+    bool expandRecurrencesLocally() const { return m_expandRecurrencesLocally; }
+    
+    // 要取得及增量同步事件的行事曆（預設只有 primary），每個行事曆各有一筆同步狀態
+    void setCalendarIds(const QStringList& calendarIds) { m_calendarIds = calendarIds.isEmpty() ? QStringList{"primary"} : calendarIds; }
+    QStringList calendarIds() const { return m_calendarIds; }
+    
     void authenticate() override;
     void fetchEvents(const QDateTime& start, const QDateTime& end) override;
     void fetchTasks() override;
+    void syncEvents(const QDateTime& start, const QDateTime& end, const QHash<QString, QString>& syncStates) override;
+    
+    Platform platform() const override { return Platform::Google; }
+    QStringList syncCalendarIds() const override { return m_calendarIds; }
     
 private slots:
     void onAuthenticationGranted();
     void onAuthenticationError(const QString& error, const QString& errorDescription);
+    void onIdentityReplyFinished();
     void onEventsReplyFinished();
     void onTasksReplyFinished();
+    void onReplyReadyRead();
     
 private:
     QNetworkAccessManager* m_networkManager;
     QOAuth2AuthorizationCodeFlow* m_oauth;
     QOAuthHttpServerReplyHandler* m_replyHandler;
+    RequestBatcher* m_batcher;
     
     QString m_clientId;
     QString m_clientSecret;
     QString m_accessToken;
+    bool m_expandRecurrencesLocally = false;
+    QStringList m_calendarIds;
+    
+    // 取得或同步進行中的時間範圍；syncToken 失效的行事曆以此重新建立基準
+    bool m_syncing = false;
+    QDateTime m_syncStart;
+    QDateTime m_syncEnd;
+    
+    // 背景解析中的單頁回應：readyRead 的片段交給工作者，元素完成即轉為事件或任務。
+    // restarted 表示 syncToken 已失效、改由新的基準請求取代的分頁
+    struct PendingPage : EventPageJob {
+        PendingPage() : EventPageJob("items") {}
+        QList<Task> tasks;
+        QString calendarId;
+        bool restarted = false;
+    };
+    using PagePtr = QSharedPointer<PendingPage>;
+    QHash<QNetworkReply*, PagePtr> m_pendingPages;
+    
+    // 分頁取得進行中的狀態；新的 fetchEvents / syncEvents 會讓舊的分頁回應失效
+    ParseReorderBuffer m_eventPages;
+    int m_fetchedEventCount = 0;
+    int m_activeCalendars = 0;
     
     void setupOAuth();
-    QList<CalendarEvent> parseEventsJson(const QByteArray& json);
-    QList<Task> parseTasksJson(const QByteArray& json);
+    CalendarEvent parseEventItem(const QJsonObject& item, const QString& ownerId) const;
+    QString ownerIdOf(const QString& calendarId) const;
+    static QString calendarIdOf(const QUrl& url);
+    Task parseTaskItem(const QJsonObject& item) const;
+    void startEvents(const QDateTime& start, const QDateTime& end,
+                     const QHash<QString, QString>& syncStates, bool syncing);
+    QUrl eventsUrl(const QString& calendarId, const QString& syncToken) const;
+    void requestEventsPage(const QUrl& url);
+    void requestBatchedEventsPage(const QUrl& url);
+    PagePtr createEventsPage(const QUrl& url);
+    void restartCalendar(const PagePtr& page);
+    static QUrl nextPageUrl(const QUrl& url, const QString& pageToken);
+    QNetworkRequest createRequest(const QUrl& url) const;
+    PagePtr createPage(const QString& label) const;
+    void attachPage(QNetworkReply* reply, const PagePtr& page);
+    void schedule(const QString& api, const QNetworkRequest& request,
+                  std::function<void(QNetworkReply*)> attach, std::function<bool()> cancelled = nullptr);
+    void closePage(QNetworkReply* reply, const PagePtr& page, const QString& errorPrefix,
+                   StreamParseJob::Completion done);
+    void deliverEventsPage(const PagePtr& page);
 };
@@ -0,0 +1,361 @@
+#include "JsonStreamParser.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+bool isJsonSpace(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+bool isNumberChar(char c) {
+    return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+} // namespace
+
+JsonStreamParser::JsonStreamParser(const QString& arrayKey)
+    : m_arrayKey(arrayKey)
+    , m_record(benchmarkEnabled())
+{
+}
+
+bool JsonStreamParser::benchmarkEnabled() {
+    static const bool enabled = qEnvironmentVariableIsSet("CALENDAR_JSON_BENCHMARK");
+    return enabled;
+}
+
+bool JsonStreamParser::fail(const QString& message) {
+    if (m_error.isEmpty()) {
+        m_error = message;
+    }
+    m_buffer.clear();
+    return false;
+}
+
+bool JsonStreamParser::feed(const QByteArray& chunk) {
+    if (hasError()) {
+        return false;
+    }
+    if (m_record) {
+        m_recorded += chunk;
+    }
+    
+    m_buffer += chunk;
+    m_maxBufferedBytes = std::max<qint64>(m_maxBufferedBytes, m_buffer.size());
+    return parseBuffer(false);
+}
+
+bool JsonStreamParser::finish() {
+    if (hasError()) {
+        return false;
+    }
+    if (!parseBuffer(true)) {
+        return false;
+    }
+    if (!m_done || !m_stack.isEmpty()) {
+        return fail("JSON 回應不完整");
+    }
+    return true;
+}
+
+bool JsonStreamParser::beginContainer(bool isObject) {
+    if (m_done) {
+        return fail("JSON 根值之後仍有資料");
+    }
+    
+    Frame frame;
+    frame.isObject = isObject;
+    
+    // 根物件中的 arrayKey 陣列以串流方式處理
+    if (!isObject && m_stack.size() == 1 && m_stack[0].isObject && m_stack[0].hasKey &&
+        m_stack[0].key == m_arrayKey && !m_arrayKey.isEmpty()) {
+        frame.streaming = true;
+    } else if (!m_stack.isEmpty() && m_stack.last().isObject && !m_stack.last().hasKey) {
+        return fail("JSON 物件缺少鍵");
+    }
+    
+    m_stack.append(frame);
+    return true;
+}
+
+bool JsonStreamParser::endContainer(bool isObject) {
+    if (m_stack.isEmpty() || m_stack.last().isObject != isObject) {
+        return fail("JSON 括號不對稱");
+    }
+    
+    Frame frame = m_stack.takeLast();
+    if (frame.streaming) {
+        // 元素已逐一回呼，陣列本身不保留
+        m_stack.last().hasKey = false;
+        return true;
+    }
+    return addValue(isObject ? QJsonValue(frame.object) : QJsonValue(frame.array));
+}
+
+bool JsonStreamParser::addValue(const QJsonValue& value) {
+    if (m_stack.isEmpty()) {
+        m_done = true;
+        return true;
+    }
+    
+    Frame& top = m_stack.last();
+    if (top.isObject) {
+        if (!top.hasKey) {
+            return fail("JSON 物件缺少鍵");
+        }
+        if (m_stack.size() == 1) {
+            // 根物件的欄位直接交給呼叫端，不累積
+            if (m_fieldHandler) {
+                m_fieldHandler(top.key, value);
+            }
+        } else {
+            top.object.insert(top.key, value);
+        }
+        top.hasKey = false;
+    } else if (top.streaming) {
+        ++m_itemCount;
+        if (m_itemHandler) {
+            m_itemHandler(value.toObject());
+        }
+    } else {
+        top.array.append(value);
+    }
+    return true;
+}
+
+bool JsonStreamParser::decodeString(const char* begin, const char* end, QString* out) {
+    const char* backslash = static_cast<const char*>(std::memchr(begin, '\\', end - begin));
+    if (!backslash) {
+        *out = QString::fromUtf8(begin, end - begin);
+        return true;
+    }
+    
+    QString result;
+    result.reserve(int(end - begin));
+    const char* run = begin;
+    const char* p = backslash;
+    while (p < end) {
+        if (*p != '\\') {
+            ++p;
+            continue;
+        }
+        result += QString::fromUtf8(run, p - run);
+        if (p + 1 >= end) {
+            return false;
+        }
+        
+        switch (p[1]) {
+            case '"': result += QLatin1Char('"'); break;
+            case '\\': result += QLatin1Char('\\'); break;
+            case '/': result += QLatin1Char('/'); break;
+            case 'b': result += QLatin1Char('\b'); break;
+            case 'f': result += QLatin1Char('\f'); break;
+            case 'n': result += QLatin1Char('\n'); break;
+            case 'r': result += QLatin1Char('\r'); break;
+            case 't': result += QLatin1Char('\t'); break;
+            case 'u': {
+                // 代理對會分成兩個 \u 逸出，依序附加即為正確的 UTF-16
+                if (p + 6 > end) {
+                    return false;
+                }
+                bool ok = false;
+                const ushort code = QByteArray(p + 2, 4).toUShort(&ok, 16);
+                if (!ok) {
+                    return false;
+                }
+                result += QChar(code);
+                p += 6;
+                run = p;
+                continue;
+            }
+            default:
+                return false;
+        }
+        p += 2;
+        run = p;
+    }
+    result += QString::fromUtf8(run, end - run);
+    
+    *out = result;
+    return true;
+}
+
+bool JsonStreamParser::parseBuffer(bool atEnd) {
+    const char* data = m_buffer.constData();
+    const int size = int(m_buffer.size());
+    int pos = 0;
+    
+    while (pos < size) {
+        const char c = data[pos];
+        if (isJsonSpace(c)) {
+            ++pos;
+            continue;
+        }
+        
+        if (c == '{' || c == '[') {
+            if (!beginContainer(c == '{')) {
+                return false;
+            }
+            ++pos;
+        } else if (c == '}' || c == ']') {
+            if (!endContainer(c == '}')) {
+                return false;
+            }
+            ++pos;
+        } else if (c == ':' || c == ',') {
+            ++pos;
+        } else if (c == '"') {
+            // 找出結尾的引號；未完成的字串保留到下一段資料
+            int i = pos + 1 + m_stringScanOffset;
+            bool closed = false;
+            while (i < size) {
+                if (data[i] == '\\') {
+                    if (i + 1 >= size) {
+                        break;
+                    }
+                    i += 2;
+                    continue;
+                }
+                if (data[i] == '"') {
+                    closed = true;
+                    break;
+                }
+                ++i;
+            }
+            if (!closed) {
+                if (atEnd) {
+                    return fail("JSON 字串未結束");
+                }
+                m_stringScanOffset = i - pos - 1;
+                break;
+            }
+            m_stringScanOffset = 0;
+            
+            QString text;
+            if (!decodeString(data + pos + 1, data + i, &text)) {
+                return fail("JSON 字串逸出格式錯誤");
+            }
+            pos = i + 1;
+            
+            if (!m_stack.isEmpty() && m_stack.last().isObject && !m_stack.last().hasKey) {
+                m_stack.last().key = text;
+                m_stack.last().hasKey = true;
+            } else if (!addValue(QJsonValue(text))) {
+                return false;
+            }
+        } else if (c == 't' || c == 'f' || c == 'n') {
+            const char* literal = c == 't' ? "true" : (c == 'f' ? "false" : "null");
+            const int length = int(std::strlen(literal));
+            if (pos + length > size) {
+                if (atEnd) {
+                    return fail("JSON 常值不完整");
+                }
+                break;
+            }
+            if (std::memcmp(data + pos, literal, length) != 0) {
+                return fail("JSON 常值格式錯誤");
+            }
+            const QJsonValue value = c == 'n' ? QJsonValue(QJsonValue::Null) : QJsonValue(c == 't');
+            if (!addValue(value)) {
+                return false;
+            }
+            pos += length;
+        } else if (c == '-' || (c >= '0' && c <= '9')) {
+            int end = pos;
+            while (end < size && isNumberChar(data[end])) {
+                ++end;
+            }
+            // 數字可能被切在兩段資料之間
+            if (end == size && !atEnd) {
+                break;
+            }
+            
+            const QByteArray number(data + pos, end - pos);
+            bool ok = false;
+            QJsonValue value;
+            if (number.contains('.') || number.contains('e') || number.contains('E')) {
+                value = QJsonValue(number.toDouble(&ok));
+            } else {
+                const qint64 integer = number.toLongLong(&ok);
+                value = ok ? QJsonValue(integer) : QJsonValue(number.toDouble(&ok));
+            }
+            if (!ok) {
+                return fail("JSON 數字格式錯誤");
+            }
+            if (!addValue(value)) {
+                return false;
+            }
+            pos = end;
+        } else {
+            return fail(QString("JSON 出現非預期的字元 '%1'").arg(QLatin1Char(c)));
+        }
+    }
+    
+    m_buffer.remove(0, pos);
+    return true;
+}
+
+JsonStreamParser::BenchmarkResult JsonStreamParser::benchmark(const QByteArray& json, const QString& arrayKey,
+                                                              int chunkSize, int iterations) {
+    BenchmarkResult result;
+    result.inputBytes = json.size();
+    iterations = std::max(1, iterations);
+    chunkSize = std::max(1, chunkSize);
+    
+    QElapsedTimer timer;
+    double domBest = std::numeric_limits<double>::max();
+    double streamBest = std::numeric_limits<double>::max();
+    
+    for (int run = 0; run < iterations; ++run) {
+        // DOM：整份回應建立文件後才能走訪元素
+        timer.start();
+        const QJsonArray items = QJsonDocument::fromJson(json).object().value(arrayKey).toArray();
+        int domItems = 0;
+        for (const QJsonValue& item : items) {
+            domItems += item.toObject().isEmpty() ? 0 : 1;
+        }
+        domBest = std::min(domBest, timer.nsecsElapsed() / 1e6);
+        
+        // 串流：依網路片段大小分段餵入
+        JsonStreamParser parser(arrayKey);
+        parser.m_record = false;
+        double firstItemMs = -1.0;
+        int streamItems = 0;
+        timer.start();
+        parser.setItemHandler([&](const QJsonObject& item) {
+            if (firstItemMs < 0) {
+                firstItemMs = timer.nsecsElapsed() / 1e6;
+            }
+            streamItems += item.isEmpty() ? 0 : 1;
+        });
+        for (int offset = 0; offset < json.size(); offset += chunkSize) {
+            parser.feed(json.mid(offset, chunkSize));
+        }
+        parser.finish();
+        const double streamMs = timer.nsecsElapsed() / 1e6;
+        if (streamMs < streamBest) {
+            streamBest = streamMs;
+            result.streamFirstItemMs = std::max(0.0, firstItemMs);
+        }
+        
+        result.items = std::max(domItems, streamItems);
+        result.streamMaxBufferedBytes = parser.maxBufferedBytes();
+    }
+    
+    result.domMs = domBest;
+    result.streamMs = streamBest;
+    return result;
+}
+
+void JsonStreamParser::logBenchmark(const QByteArray& json, const QString& arrayKey, const QString& label) {
+    const BenchmarkResult result = benchmark(json, arrayKey);
+    qDebug().nospace() << "JSON 解析比較 (" << label << ")：" << result.items << " 筆、"
+                       << result.inputBytes << " bytes；DOM " << result.domMs << " ms（須保留完整回應），串流 "
+                       << result.streamMs << " ms，第一筆 " << result.streamFirstItemMs
+                       << " ms，最多暫存 " << result.streamMaxBufferedBytes << " bytes";
+}
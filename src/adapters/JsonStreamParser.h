@@ -0,0 +1,90 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QJsonValue>
+#include <functional>
+
+// 串流 JSON 解析器 - 以 QNetworkReply::readyRead 的資料片段逐段餵入，
+// 不保留整份回應。根物件中名為 arrayKey 的陣列（Google 的 items、Graph 的 value）
+// 每個元素完成時即以 itemHandler 回呼並丟棄；根物件的其他欄位（nextPageToken、
+// @odata.nextLink 等）解析完成時以 fieldHandler 回呼。
+class JsonStreamParser {
+public:
+    using ItemHandler = std::function<void(const QJsonObject& item)>;
+    using FieldHandler = std::function<void(const QString& key, const QJsonValue& value)>;
+    
+    // 與 DOM 解析 (QJsonDocument) 的比較結果
+    struct BenchmarkResult {
+        int items = 0;
+        qint64 inputBytes = 0;
+        double domMs = 0.0;
+        double streamMs = 0.0;
+        double streamFirstItemMs = 0.0;  // DOM 必須解析完整份回應才有第一筆
+        qint64 streamMaxBufferedBytes = 0;
+    };
+    
+    explicit JsonStreamParser(const QString& arrayKey = QString());
+    
+    void setArrayKey(const QString& arrayKey) { m_arrayKey = arrayKey; }
+    QString arrayKey() const { return m_arrayKey; }
+    void setItemHandler(ItemHandler handler) { m_itemHandler = std::move(handler); }
+    void setFieldHandler(FieldHandler handler) { m_fieldHandler = std::move(handler); }
+    
+    // 餵入下一段資料；語法錯誤時回傳 false，之後的資料都會被忽略
+    bool feed(const QByteArray& chunk);
+    
+    // 資料已全部送達，檢查文件是否完整
+    bool finish();
+    
+    bool hasError() const { return !m_error.isEmpty(); }
+    QString errorString() const { return m_error; }
+    int itemCount() const { return m_itemCount; }
+    
+    // 等待後續資料而暫存的最大位元組數（通常只是一個未完成的字串或數字）
+    qint64 maxBufferedBytes() const { return m_maxBufferedBytes; }
+    
+    // 設定 CALENDAR_JSON_BENCHMARK 環境變數時，解析器會保留原始輸入供比較
+    static bool benchmarkEnabled();
+    const QByteArray& recordedInput() const { return m_recorded; }
+    
+    // 以相同輸入分別執行 DOM 解析與分段串流解析
+    static BenchmarkResult benchmark(const QByteArray& json, const QString& arrayKey,
+                                     int chunkSize = 16 * 1024, int iterations = 5);
+    static void logBenchmark(const QByteArray& json, const QString& arrayKey, const QString& label);
+    
+private:
+    struct Frame {
+        bool isObject = true;
+        bool streaming = false;  // arrayKey 陣列：元素完成即回呼，不累積
+        bool hasKey = false;
+        QString key;
+        QJsonObject object;
+        QJsonArray array;
+    };
+    
+    bool parseBuffer(bool atEnd);
+    bool beginContainer(bool isObject);
+    bool endContainer(bool isObject);
+    bool addValue(const QJsonValue& value);
+    bool fail(const QString& message);
+    static bool decodeString(const char* begin, const char* end, QString* out);
+    
+    QString m_arrayKey;
+    ItemHandler m_itemHandler;
+    FieldHandler m_fieldHandler;
+    
+    QByteArray m_buffer;
+    int m_stringScanOffset = 0;  // 未完成字串已掃描的長度，下次從這裡繼續
+    QVector<Frame> m_stack;
+    bool m_done = false;
+    QString m_error;
+    int m_itemCount = 0;
+    qint64 m_maxBufferedBytes = 0;
+    
+    bool m_record = false;
+    QByteArray m_recorded;
+};
@@ -7,8 +7,16 @@
 #include <QNetworkReply>
 #include <QUrlQuery>
 #include <QDateTime>
+#include <QHash>
+#include <QTimeZone>
 #include <QAbstractOAuth>
 
+// 只取回 parseEventItem / parseTaskItem 會用到的欄位；nextLink 會保留 $select
+static const char* const kEventSelect =
+    "id,subject,body,location,start,end,isAllDay,originalStartTimeZone,attendees,recurrence,uid,iCalUId,"
+    "seriesMasterId,originalStart,isCancelled";
+static const char* const kTaskSelect = "id,title,body,status,dueDateTime,importance,categories";
+
 OutlookCalendarAdapter::OutlookCalendarAdapter(QObject* parent)
     : CalendarAdapter(parent)
     , m_networkManager(new QNetworkAccessManager(this))
@@ -16,14 +24,21 @@ OutlookCalendarAdapter::OutlookCalendarAdapter(QObject* parent)
     , m_replyHandler(nullptr)
     , m_tenantId("common")
 {
+    m_batcher = new RequestBatcher(RequestBatcher::Format::Graph, m_networkManager, this);
+    m_batcher->setUserAgent(kUserAgent);
 }
 
-OutlookCalendarAdapter::~OutlookCalendarAdapter() = default;
+OutlookCalendarAdapter::~OutlookCalendarAdapter() {
+    // 工作者的回呼會呼叫 parseEventItem，需等解析結束
+    ResponseParseStage::waitForDone();
+}
 
 void OutlookCalendarAdapter::setCredentials(const QString& clientId, const QString& clientSecret, const QString& tenantId) {
     m_clientId = clientId;
     m_clientSecret = clientSecret;
     m_tenantId = tenantId;
+    setAccount("outlook:" + tenantId + ":" + clientId);
+    m_batcher->setSchedulerBucket(account() + "/graph");
     setupOAuth();
 }
 
@@ -84,7 +99,32 @@ void OutlookCalendarAdapter::authenticate() {
 
 void OutlookCalendarAdapter::onAuthenticationGranted() {
     m_accessToken = m_oauth->token();
+    m_batcher->setAccessToken(m_accessToken);
     qDebug() << "Microsoft Outlook 認證成功！";
+    
+    // /me 的 userPrincipalName 作為事件的擁有者
+    QUrl url("https://graph.microsoft.com/v1.0/me");
+    url.setQuery("$select=userPrincipalName");
+    schedule(createRequest(url), [this](QNetworkReply* reply) {
+        connect(reply, &QNetworkReply::finished, this, &OutlookCalendarAdapter::onIdentityReplyFinished);
+    });
+}
+
+void OutlookCalendarAdapter::onIdentityReplyFinished() {
+    QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
+    if (!reply) return;
+    
+    if (reply->error() == QNetworkReply::NoError) {
+        setOwner("outlook", QJsonDocument::fromJson(reply->readAll()).object()["userPrincipalName"].toString(),
+                 m_accessToken);
+        qDebug() << "Microsoft Outlook 帳號:" << ownerId();
+    } else {
+        // 取不到帳號時仍可使用，只是事件不標記擁有者
+        qDebug() << "取得 Microsoft Outlook 帳號失敗:" << reply->errorString();
+        setOwner("outlook", QString(), m_accessToken);
+    }
+    
+    reply->deleteLater();
     emit authenticated();
 }
 
@@ -95,43 +135,273 @@ void OutlookCalendarAdapter::onAuthenticationError(const QString& error, const Q
 }
 
 void OutlookCalendarAdapter::fetchEvents(const QDateTime& start, const QDateTime& end) {
-    if (m_accessToken.isEmpty()) {
-        emit errorOccurred("尚未認證，請先呼叫 authenticate()");
-        return;
-    }
-    
     // 構建 Microsoft Graph API 請求
     QUrl url("https://graph.microsoft.com/v1.0/me/calendarview");
     QUrlQuery query;
     query.addQueryItem("startDateTime", start.toUTC().toString(Qt::ISODate));
     query.addQueryItem("endDateTime", end.toUTC().toString(Qt::ISODate));
     query.addQueryItem("$orderby", "start/dateTime");
+    query.addQueryItem("$top", QString::number(pageSize()));
+    if (fieldProjection()) {
+        query.addQueryItem("$select", kEventSelect);
+    }
     url.setQuery(query);
     
+    startEvents(url, false);
+}
+
+void OutlookCalendarAdapter::syncEvents(const QDateTime& start, const QDateTime& end,
+                                        const QHash<QString, QString>& syncStates) {
+    m_syncStart = start;
+    m_syncEnd = end;
+    
+    // 已有 deltaLink 時直接使用；否則以 calendarView/delta 建立基準
+    const QString deltaLink = syncStates.value(kSyncCalendarId);
+    startEvents(deltaLink.isEmpty() ? deltaBaselineUrl() : QUrl(deltaLink), true);
+}
+
+QUrl OutlookCalendarAdapter::deltaBaselineUrl() const {
+    // calendarView/delta 不支援 $select，只能以 Prefer 取回純文字內文
+    QUrl url("https://graph.microsoft.com/v1.0/me/calendarView/delta");
+    QUrlQuery query;
+    query.addQueryItem("startDateTime", m_syncStart.toUTC().toString(Qt::ISODate));
+    query.addQueryItem("endDateTime", m_syncEnd.toUTC().toString(Qt::ISODate));
+    url.setQuery(query);
+    return url;
+}
+
+void OutlookCalendarAdapter::startEvents(const QUrl& url, bool syncing) {
+    if (m_accessToken.isEmpty()) {
+        emit errorOccurred("尚未認證，請先呼叫 authenticate()");
+        return;
+    }
+    
+    m_syncing = syncing;
+    m_eventPages.reset();
+    pageCache().begin();
+    resetTransferStats();
+    m_fetchedEventCount = 0;
+    requestEventsPage(url);
+}
+
+void OutlookCalendarAdapter::requestEventsPage(const QUrl& url) {
+    // calendarView/delta 不支援 $top，每頁大小以 Prefer 指定
+    QNetworkRequest request = m_syncing
+        ? createRequest(url, QString("odata.maxpagesize=%1").arg(pageSize()).toUtf8())
+        : createRequest(url);
+    
+    // 有快取內容時送出條件式請求，未變更的分頁回應 304；deltaLink 每次都不同，不必快取
+    const PagePtr page = createPage(m_syncing ? "同步" : "事件");
+    m_eventPages.enqueue(page.data());
+    const bool cacheable = !QUrlQuery(url).hasQueryItem("$deltatoken");
+    if (cacheable) {
+        pageCache().prepare(request, url, page.data());
+    }
+    
+    // 以下回呼在工作者執行緒執行，只寫入本頁的欄位
+    PendingPage* target = page.data();
+    const int generation = page->generation;
+    const QString ownerId = this->ownerId();
+    target->parser.setItemHandler([this, target, ownerId](const QJsonObject& item) {
+        // 增量同步回報的已刪除事件只記錄 id
+        if (item.contains("@removed")) {
+            target->removedIds.append(item["id"].toString());
+        } else {
+            target->events.append(parseEventItem(item, ownerId));
+        }
+    });
+    // 一讀到 nextLink 就送出下一頁請求，讓下一頁的傳輸與本頁的解析重疊；nextLink 已包含 $top 與 $skip
+    target->parser.setFieldHandler([this, target, generation](const QString& key, const QJsonValue& value) {
+        if (key == "@odata.deltaLink") {
+            target->syncState = value.toString();
+            return;
+        }
+        if (key != "@odata.nextLink") {
+            return;
+        }
+        target->nextPage = value.toString();
+        const QUrl next(target->nextPage);
+        QMetaObject::invokeMethod(this, [this, next, generation]() {
+            if (generation == m_eventPages.generation()) {
+                requestEventsPage(next);
+            }
+        }, Qt::QueuedConnection);
+    });
+    
+    schedule(request, [this, page, cacheable](QNetworkReply* reply) {
+        if (cacheable) {
+            pageCache().track(reply, page.data());
+        }
+        trackTransfer(reply);
+        attachPage(reply, page);
+        reply->setProperty("fetchGeneration", page->generation);
+        connect(reply, &QNetworkReply::finished, this, &OutlookCalendarAdapter::onEventsReplyFinished);
+    }, [this, generation]() {
+        return generation != m_eventPages.generation();
+    });
+    
+    // stale-while-revalidate：先送出上次的結果，重新驗證的結果之後經由 deliverEventsPage 送出
+    if (cacheable) {
+        if (const auto stale = pageCache().serveStale(page.data())) {
+            emit eventsReceived(stale->events);
+        }
+    }
+}
+
+QNetworkRequest OutlookCalendarAdapter::createRequest(const QUrl& url, const QByteArray& prefer) const {
     QNetworkRequest request(url);
     request.setRawHeader("Authorization", QString("Bearer %1").arg(m_accessToken).toUtf8());
     request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+    request.setHeader(QNetworkRequest::UserAgentHeader, kUserAgent);
     
-    QNetworkReply* reply = m_networkManager->get(request);
-    connect(reply, &QNetworkReply::finished, this, &OutlookCalendarAdapter::onEventsReplyFinished);
+    // 多個偏好以逗號合併在同一個 Prefer 標頭
+    QByteArrayList preferences;
+    if (!prefer.isEmpty()) {
+        preferences.append(prefer);
+    }
+    if (m_preferTextBody) {
+        preferences.append("outlook.body-content-type=\"text\"");
+    }
+    if (!preferences.isEmpty()) {
+        request.setRawHeader("Prefer", preferences.join(", "));
+    }
+    return request;
 }
 
-void OutlookCalendarAdapter::onEventsReplyFinished() {
+OutlookCalendarAdapter::PagePtr OutlookCalendarAdapter::createPage(const QString& label) const {
+    const PagePtr page = PagePtr::create();
+    page->label = "Outlook " + label;
+    return page;
+}
+
+void OutlookCalendarAdapter::attachPage(QNetworkReply* reply, const PagePtr& page) {
+    m_pendingPages.insert(reply, page);
+    connect(reply, &QNetworkReply::readyRead, this, &OutlookCalendarAdapter::onReplyReadyRead);
+}
+
+void OutlookCalendarAdapter::schedule(const QNetworkRequest& request, std::function<void(QNetworkReply*)> attach,
+                                      std::function<bool()> cancelled) {
+    // 經由共用的排程器送出；暫時失敗時排程器捨棄舊回應並以新的回應重新 attach
+    RequestScheduler::Request scheduled;
+    scheduled.bucket = account() + "/graph";
+    scheduled.context = this;
+    scheduled.send = [this, request]() {
+        return m_networkManager->get(request);
+    };
+    scheduled.attach = std::move(attach);
+    scheduled.detach = [this](QNetworkReply* reply) {
+        m_pendingPages.remove(reply);
+        pageCache().discard(reply);
+    };
+    scheduled.cancelled = std::move(cancelled);
+    RequestScheduler::instance()->submit(scheduled);
+}
+
+void OutlookCalendarAdapter::onReplyReadyRead() {
     QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
     if (!reply) return;
     
-    if (reply->error() == QNetworkReply::NoError) {
-        QByteArray data = reply->readAll();
-        QList<CalendarEvent> events = parseEventsJson(data);
-        qDebug() << "獲取到" << events.size() << "個 Outlook 事件";
-        emit eventsReceived(events);
-    } else {
-        QString error = QString("獲取事件失敗: %1").arg(reply->errorString());
-        qDebug() << error;
-        emit errorOccurred(error);
+    // 已被新的 fetchEvents / syncEvents 取代的分頁不必再解析
+    const QVariant generation = reply->property("fetchGeneration");
+    if (generation.isValid() && generation.toInt() != m_eventPages.generation()) {
+        return;
     }
     
+    // 錯誤回應的內容不解析，由 finished 處理
+    if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 200) {
+        return;
+    }
+    
+    const PagePtr page = m_pendingPages.value(reply);
+    if (page) {
+        const QByteArray chunk = readChunk(reply);
+        pageCache().write(reply, chunk);
+        page->append(chunk);
+    }
+}
+
+void OutlookCalendarAdapter::closePage(QNetworkReply* reply, const PagePtr& page, const QString& errorPrefix,
+                                       StreamParseJob::Completion done) {
+    const QByteArray rest = reply->error() == QNetworkReply::NoError ? readChunk(reply) : QByteArray();
+    pageCache().close(reply, rest, page.data(), errorPrefix, this, std::move(done));
+}
+
+void OutlookCalendarAdapter::onEventsReplyFinished() {
+    QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
+    if (!reply) return;
     reply->deleteLater();
+    
+    // 已開始新的 fetchEvents / syncEvents，舊的分頁不再處理
+    const PagePtr page = m_pendingPages.take(reply);
+    if (!page || page->generation != m_eventPages.generation()) {
+        pageCache().discard(reply);
+        return;
+    }
+    
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (status == 410) {
+        // deltaLink 已失效：清除同步狀態並重新建立基準；失效的分頁不解析，直接標記後交付
+        qDebug() << "Graph deltaLink 已失效，重新完整同步";
+        pageCache().discard(reply);
+        emit syncStateUpdated(kSyncCalendarId, QString());
+        page->restarted = true;
+        requestEventsPage(deltaBaselineUrl());
+        deliverEventsPage(page);
+        return;
+    }
+    
+    const auto done = [this, page]() {
+        deliverEventsPage(page);
+    };
+    if (status != 304) {
+        closePage(reply, page, "獲取事件失敗", done);
+    } else if (pageCache().reuse(reply, page.data(), this, done)) {
+        if (!page->nextPage.isEmpty()) {
+            requestEventsPage(QUrl(page->nextPage));
+        }
+        deliverEventsPage(page);
+    }
+}
+
+void OutlookCalendarAdapter::deliverEventsPage(const PagePtr& page) {
+    // 分頁可能不依序解析完成，依請求順序送出
+    const QList<QSharedPointer<StreamParseJob>> ready = m_eventPages.complete(page);
+    for (const QSharedPointer<StreamParseJob>& job : ready) {
+        const PendingPage* parsed = static_cast<const PendingPage*>(job.data());
+        if (parsed->restarted) {
+            continue;
+        }
+        if (!parsed->error.isEmpty()) {
+            qDebug() << parsed->error;
+            pageCache().fail(parsed);
+            emit errorOccurred(parsed->error);
+            m_eventPages.reset();
+            return;
+        }
+        
+        m_fetchedEventCount += parsed->events.size();
+        if (pageCache().deliver(job)) {
+            if (m_syncing) {
+                emit eventChangesReceived(parsed->events, parsed->removedIds);
+            } else {
+                emit eventsReceived(parsed->events);
+            }
+        }
+        
+        // 最後一頁帶回新的 deltaLink
+        if (parsed->nextPage.isEmpty()) {
+            if (m_syncing && !parsed->syncState.isEmpty()) {
+                emit syncStateUpdated(kSyncCalendarId, parsed->syncState);
+            }
+            qDebug() << (m_syncing ? "同步到" : "獲取到") << m_fetchedEventCount << "個 Outlook 事件";
+            const QStringList removed = pageCache().finish();
+            if (!removed.isEmpty()) {
+                qDebug() << "重新驗證後有" << removed.size() << "個先行送出的快取事件已不存在";
+                emit eventChangesReceived({}, removed);
+            }
+            emit fetchCompleted(m_fetchedEventCount);
+        }
+    }
 }
 
 void OutlookCalendarAdapter::fetchTasks() {
@@ -140,112 +410,354 @@ void OutlookCalendarAdapter::fetchTasks() {
         return;
     }
     
-    // 構建 Microsoft Graph API 請求 (Microsoft To Do)
+    // Microsoft To Do：先列出所有清單，再分別取得每個清單的任務
+    ++m_taskGeneration;
+    m_batcher->cancelAll();
+    m_queuedTaskLists.clear();
+    m_activeTaskLists = 0;
+    m_taskListsComplete = false;
+    m_fetchedTaskCount = 0;
+    
     QUrl url("https://graph.microsoft.com/v1.0/me/todo/lists");
+    if (fieldProjection()) {
+        url.setQuery("$select=id");
+    }
+    requestTaskListsPage(url);
+}
+
+void OutlookCalendarAdapter::requestTaskListsPage(const QUrl& url) {
+    QNetworkRequest request = createRequest(url);
     
-    QNetworkRequest request(url);
-    request.setRawHeader("Authorization", QString("Bearer %1").arg(m_accessToken).toUtf8());
-    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+    const PagePtr page = createPage("任務清單");
+    page->generation = m_taskGeneration;
+    
+    // 以下回呼在工作者執行緒執行，只寫入本頁的欄位
+    PendingPage* target = page.data();
+    target->parser.setItemHandler([target](const QJsonObject& item) {
+        target->taskListIds.append(item["id"].toString());
+    });
+    target->parser.setFieldHandler([target](const QString& key, const QJsonValue& value) {
+        if (key == "@odata.nextLink") {
+            target->nextPage = value.toString();
+        }
+    });
     
-    QNetworkReply* reply = m_networkManager->get(request);
-    connect(reply, &QNetworkReply::finished, this, &OutlookCalendarAdapter::onTasksReplyFinished);
+    const int generation = page->generation;
+    schedule(request, [this, page](QNetworkReply* reply) {
+        attachPage(reply, page);
+        connect(reply, &QNetworkReply::finished, this, &OutlookCalendarAdapter::onTaskListsReplyFinished);
+    }, [this, generation]() {
+        return generation != m_taskGeneration;
+    });
 }
 
-void OutlookCalendarAdapter::onTasksReplyFinished() {
+void OutlookCalendarAdapter::onTaskListsReplyFinished() {
     QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
     if (!reply) return;
+    reply->deleteLater();
     
-    if (reply->error() == QNetworkReply::NoError) {
-        QByteArray data = reply->readAll();
-        QList<Task> tasks = parseTasksJson(data);
-        qDebug() << "獲取到" << tasks.size() << "個 Microsoft To Do 任務";
-        emit tasksReceived(tasks);
-    } else {
-        QString error = QString("獲取任務失敗: %1").arg(reply->errorString());
-        qDebug() << error;
-        emit errorOccurred(error);
+    // 已開始新的 fetchTasks，舊的回應不再處理
+    const PagePtr page = m_pendingPages.take(reply);
+    if (!page || page->generation != m_taskGeneration) {
+        return;
     }
     
-    reply->deleteLater();
+    closePage(reply, page, "獲取任務清單失敗", [this, page]() {
+        if (page->generation != m_taskGeneration) {
+            return;
+        }
+        if (!page->error.isEmpty()) {
+            qDebug() << page->error;
+            emit errorOccurred(page->error);
+            m_taskListsComplete = true;
+        } else {
+            m_queuedTaskLists += page->taskListIds;
+            if (page->nextPage.isEmpty()) {
+                m_taskListsComplete = true;
+            } else {
+                requestTaskListsPage(QUrl(page->nextPage));
+            }
+        }
+        startQueuedTaskLists();
+    });
 }
 
-QList<CalendarEvent> OutlookCalendarAdapter::parseEventsJson(const QByteArray& json) {
-    QList<CalendarEvent> events;
-    
-    QJsonDocument doc = QJsonDocument::fromJson(json);
-    if (!doc.isObject()) return events;
-    
-    QJsonObject root = doc.object();
-    QJsonArray items = root["value"].toArray();
-    
-    for (const QJsonValue& value : items) {
-        QJsonObject item = value.toObject();
-        
-        CalendarEvent event;
-        event.id = item["id"].toString();
-        event.title = item["subject"].toString();
+void OutlookCalendarAdapter::startQueuedTaskLists() {
+    // 同時進行的清單數有上限，避免觸發 Graph 的節流；同一輪送出的請求會打包成一個 $batch
+    while (m_activeTaskLists < m_maxParallelTaskLists && !m_queuedTaskLists.isEmpty()) {
+        const QString listId = m_queuedTaskLists.takeFirst();
+        ++m_activeTaskLists;
         
-        // 解析 body
-        QJsonObject bodyObj = item["body"].toObject();
-        event.description = bodyObj["content"].toString();
+        QUrl url(QString("https://graph.microsoft.com/v1.0/me/todo/lists/%1/tasks").arg(listId));
+        QUrlQuery query;
+        query.addQueryItem("$top", QString::number(pageSize()));
+        if (fieldProjection()) {
+            query.addQueryItem("$select", kTaskSelect);
+        }
+        url.setQuery(query);
+        requestTasksPage(url);
+    }
+    
+    if (m_taskListsComplete && m_activeTaskLists == 0) {
+        qDebug() << "Microsoft To Do 任務已全部取得，共" << m_fetchedTaskCount << "個";
+    }
+}
+
+void OutlookCalendarAdapter::requestTasksPage(const QUrl& url) {
+    const int generation = m_taskGeneration;
+    m_batcher->enqueue(url, [this, generation](const RequestBatcher::Response& response) {
+        if (generation != m_taskGeneration) {
+            return;
+        }
         
-        // 解析 location
-        QJsonObject locationObj = item["location"].toObject();
-        event.location = locationObj["displayName"].toString();
+        const PagePtr page = createPage("任務");
+        page->generation = generation;
         
-        event.platform = Platform::Outlook;
+        // 以下回呼在工作者執行緒執行，只寫入本頁的欄位
+        PendingPage* target = page.data();
+        target->parser.setItemHandler([this, target](const QJsonObject& item) {
+            target->tasks.append(parseTaskItem(item));
+        });
+        // 同一清單的下一頁沿用目前的並行名額，與其他清單的請求一起打包
+        target->parser.setFieldHandler([this, target, generation](const QString& key, const QJsonValue& value) {
+            if (key != "@odata.nextLink") {
+                return;
+            }
+            target->nextPage = value.toString();
+            const QUrl next(target->nextPage);
+            QMetaObject::invokeMethod(this, [this, next, generation]() {
+                if (generation == m_taskGeneration) {
+                    requestTasksPage(next);
+                }
+            }, Qt::QueuedConnection);
+        });
         
-        // 解析開始時間
-        QJsonObject startObj = item["start"].toObject();
+        const auto done = [this, page]() {
+            deliverTasksPage(page);
+        };
+        if (!response.error.isEmpty()) {
+            page->closeWithError(QString("獲取任務失敗: %1").arg(response.error), this, done);
+        } else {
+            page->close(response.body, this, done);
+        }
+    });
+}
+
+void OutlookCalendarAdapter::deliverTasksPage(const PagePtr& page) {
+    if (page->generation != m_taskGeneration) {
+        return;
+    }
+    
+    // 各清單的結果一到就送出，合併為同一個 tasksReceived 串流；單一清單失敗不影響其他清單
+    if (!page->error.isEmpty()) {
+        qDebug() << page->error;
+        emit errorOccurred(page->error);
+    } else if (!page->tasks.isEmpty()) {
+        m_fetchedTaskCount += page->tasks.size();
+        emit tasksReceived(page->tasks);
+    }
+    
+    // 已送出下一頁時，名額由下一頁繼續佔用
+    if (page->nextPage.isEmpty()) {
+        --m_activeTaskLists;
+        startQueuedTaskLists();
+    }
+}
+
+CalendarEvent OutlookCalendarAdapter::parseEventItem(const QJsonObject& item, const QString& ownerId) const {
+    CalendarEvent event;
+    event.id = item["id"].toString();
+    event.ownerId = ownerId;
+    event.title = item["subject"].toString();
+    
+    // 解析 body
+    QJsonObject bodyObj = item["body"].toObject();
+    event.description = bodyObj["content"].toString();
+    
+    // 解析 location
+    QJsonObject locationObj = item["location"].toObject();
+    event.location = locationObj["displayName"].toString();
+    
+    event.platform = Platform::Outlook;
+    
+    // 解析開始與結束時間；全天事件以日期為準，不隨時區移動
+    QJsonObject startObj = item["start"].toObject();
+    QJsonObject endObj = item["end"].toObject();
+    event.isAllDay = item["isAllDay"].toBool();
+    if (event.isAllDay) {
         event.startTime = QDateTime::fromString(startObj["dateTime"].toString(), Qt::ISODate);
-        event.isAllDay = item["isAllDay"].toBool();
-        
-        // 解析結束時間
-        QJsonObject endObj = item["end"].toObject();
         event.endTime = QDateTime::fromString(endObj["dateTime"].toString(), Qt::ISODate);
-        
-        // 解析參與者
-        QJsonArray attendees = item["attendees"].toArray();
-        for (const QJsonValue& attendee : attendees) {
-            QJsonObject emailAddress = attendee.toObject()["emailAddress"].toObject();
-            event.attendees.append(emailAddress["address"].toString());
+    } else {
+        event.startTime = dateTimeFromGraph(startObj);
+        event.endTime = dateTimeFromGraph(endObj);
+    }
+    
+    // start/end 依 Prefer 的時區（預設 UTC）回傳；改用建立事件時的時區，重複事件跨越日光節約時間時才展開正確
+    const QTimeZone zone = timeZoneFromGraph(item["originalStartTimeZone"].toString());
+    if (!event.isAllDay && zone.isValid()) {
+        event.startTime = event.startTime.toTimeZone(zone);
+        event.endTime = event.endTime.toTimeZone(zone);
+    }
+    
+    // 解析參與者
+    QJsonArray attendees = item["attendees"].toArray();
+    for (const QJsonValue& attendee : attendees) {
+        QJsonObject emailAddress = attendee.toObject()["emailAddress"].toObject();
+        event.attendees.append(emailAddress["address"].toString());
+    }
+    
+    // 解析重複規則，轉為與 Google 相同的 RRULE 格式
+    if (item.contains("recurrence") && !item["recurrence"].isNull()) {
+        event.recurrenceRule = recurrenceRuleFromGraph(item["recurrence"].toObject());
+    }
+    
+    // 跨平台比對同一會議：uid 為整個系列共用的 iCalendar UID（與 Google 的 iCalUID 相同）；
+    // iCalUId 在每個實例都不同，只在沒有 uid 時使用
+    event.iCalUid = item["uid"].toString();
+    if (event.iCalUid.isEmpty()) {
+        event.iCalUid = item["iCalUId"].toString();
+    }
+    
+    // 系列中的實例或例外
+    event.seriesMasterId = item["seriesMasterId"].toString();
+    if (item.contains("originalStart")) {
+        event.originalStartTime = QDateTime::fromString(item["originalStart"].toString(), Qt::ISODate);
+        if (zone.isValid()) {
+            event.originalStartTime = event.originalStartTime.toTimeZone(zone);
         }
-        
-        // 解析重複規則
-        if (item.contains("recurrence") && !item["recurrence"].isNull()) {
-            QJsonObject recurrenceObj = item["recurrence"].toObject();
-            QJsonObject patternObj = recurrenceObj["pattern"].toObject();
-            event.recurrenceRule = patternObj["type"].toString();
+    }
+    event.isCancelled = item["isCancelled"].toBool();
+    
+    return event;
+}
+
+QTimeZone OutlookCalendarAdapter::timeZoneFromGraph(const QString& name) {
+    // Graph 的時區可能是 "UTC"、IANA 名稱或 Windows 時區名稱（例如 "Taipei Standard Time"）
+    if (name.isEmpty()) {
+        return QTimeZone();
+    }
+    if (name == "UTC") {
+        return QTimeZone::utc();
+    }
+    const QByteArray id = name.toUtf8();
+    if (QTimeZone::isTimeZoneIdAvailable(id)) {
+        return QTimeZone(id);
+    }
+    const QByteArray ianaId = QTimeZone::windowsIdToDefaultIanaId(id);
+    return ianaId.isEmpty() ? QTimeZone() : QTimeZone(ianaId);
+}
+
+QDateTime OutlookCalendarAdapter::dateTimeFromGraph(const QJsonObject& dateTimeTimeZone) {
+    // dateTime 不含時差，以同一物件的 timeZone 解讀；沒有標示時 Graph 以 UTC 回傳
+    QDateTime dateTime = QDateTime::fromString(dateTimeTimeZone["dateTime"].toString(), Qt::ISODate);
+    const QString name = dateTimeTimeZone["timeZone"].toString();
+    const QTimeZone zone = name.isEmpty() ? QTimeZone::utc() : timeZoneFromGraph(name);
+    if (dateTime.isValid() && zone.isValid()) {
+        dateTime.setTimeZone(zone);
+    }
+    return dateTime;
+}
+
+QString OutlookCalendarAdapter::recurrenceRuleFromGraph(const QJsonObject& recurrence) {
+    static const QHash<QString, QString> weekdayCodes = {
+        {"monday", "MO"}, {"tuesday", "TU"}, {"wednesday", "WE"}, {"thursday", "TH"},
+        {"friday", "FR"}, {"saturday", "SA"}, {"sunday", "SU"}
+    };
+    static const QHash<QString, int> indexOrdinals = {
+        {"first", 1}, {"second", 2}, {"third", 3}, {"fourth", 4}, {"last", -1}
+    };
+    
+    const QJsonObject pattern = recurrence["pattern"].toObject();
+    const QJsonObject range = recurrence["range"].toObject();
+    const QString type = pattern["type"].toString();
+    
+    QStringList parts;
+    if (type == "daily") {
+        parts << "FREQ=DAILY";
+    } else if (type == "weekly") {
+        parts << "FREQ=WEEKLY";
+    } else if (type == "absoluteMonthly" || type == "relativeMonthly") {
+        parts << "FREQ=MONTHLY";
+    } else if (type == "absoluteYearly" || type == "relativeYearly") {
+        parts << "FREQ=YEARLY";
+    } else {
+        return QString();
+    }
+    
+    const int interval = pattern["interval"].toInt(1);
+    if (interval > 1) {
+        parts << QString("INTERVAL=%1").arg(interval);
+    }
+    
+    // relative 類型以 index 指定 daysOfWeek 中的第幾天，weekly 則為每週的星期幾
+    const int ordinal = type.startsWith("relative")
+        ? indexOrdinals.value(pattern["index"].toString(), 1) : 0;
+    QStringList days;
+    for (const QJsonValue& day : pattern["daysOfWeek"].toArray()) {
+        const QString code = weekdayCodes.value(day.toString().toLower());
+        if (!code.isEmpty()) {
+            days << code;
+        }
+    }
+    if (!days.isEmpty() && (type == "weekly" || type.startsWith("relative"))) {
+        if (ordinal != 0 && days.size() == 1) {
+            parts << "BYDAY=" + QString::number(ordinal) + days.first();
+        } else {
+            parts << "BYDAY=" + days.join(',');
+            // 多個星期幾時 index 是指合併後的第幾天（例如最後一個工作日），而非每個星期幾各取一次
+            if (ordinal != 0) {
+                parts << QString("BYSETPOS=%1").arg(ordinal);
+            }
+        }
+    }
+    
+    if (type.startsWith("absolute")) {
+        parts << QString("BYMONTHDAY=%1").arg(pattern["dayOfMonth"].toInt());
+    }
+    if (type.endsWith("Yearly")) {
+        parts << QString("BYMONTH=%1").arg(pattern["month"].toInt());
+    }
+    if (type == "weekly" && pattern.contains("firstDayOfWeek")) {
+        const QString code = weekdayCodes.value(pattern["firstDayOfWeek"].toString().toLower());
+        if (!code.isEmpty()) {
+            parts << "WKST=" + code;
         }
-        
-        events.append(event);
     }
     
-    return events;
+    const QString rangeType = range["type"].toString();
+    if (rangeType == "endDate") {
+        const QDate endDate = QDate::fromString(range["endDate"].toString(), Qt::ISODate);
+        parts << "UNTIL=" + endDate.toString("yyyyMMdd");
+    } else if (rangeType == "numbered") {
+        parts << QString("COUNT=%1").arg(range["numberOfOccurrences"].toInt());
+    }
+    
+    return "RRULE:" + parts.join(';');
 }
 
-QList<Task> OutlookCalendarAdapter::parseTasksJson(const QByteArray& json) {
-    QList<Task> tasks;
+Task OutlookCalendarAdapter::parseTaskItem(const QJsonObject& item) const {
+    Task task;
+    task.id = item["id"].toString();
+    task.title = item["title"].toString();
+    task.description = item["body"].toObject()["content"].toString();
+    task.platform = Platform::Outlook;
+    task.isCompleted = item["status"].toString() == "completed";
     
-    QJsonDocument doc = QJsonDocument::fromJson(json);
-    if (!doc.isObject()) return tasks;
+    // 解析到期日期
+    const QJsonObject dueObj = item["dueDateTime"].toObject();
+    if (dueObj.contains("dateTime")) {
+        task.dueDate = dateTimeFromGraph(dueObj);
+    }
     
-    QJsonObject root = doc.object();
-    QJsonArray items = root["value"].toArray();
+    // importance 對應優先順序（1 為最高）
+    static const QHash<QString, int> priorities = {
+        {"high", 1}, {"normal", 3}, {"low", 5}
+    };
+    task.priority = priorities.value(item["importance"].toString(), 3);
     
-    // 這裡獲取的是任務列表，需要進一步獲取每個列表中的任務
-    // 簡化實作，僅解析列表資訊
-    for (const QJsonValue& value : items) {
-        QJsonObject item = value.toObject();
-        
-        Task task;
-        task.id = item["id"].toString();
-        task.title = item["displayName"].toString();
-        task.platform = Platform::Outlook;
-        task.isCompleted = false;
-        
-        tasks.append(task);
+    for (const QJsonValue& category : item["categories"].toArray()) {
+        task.tags.append(category.toString());
     }
     
-    return tasks;
+    return task;
 }
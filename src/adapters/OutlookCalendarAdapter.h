@@ -1,10 +1,17 @@
 #pragma once
 
 #include "CalendarAdapter.h"
+#include "RequestBatcher.h"
+#include "RequestScheduler.h"
+#include "ResponseParseStage.h"
 #include <QNetworkAccessManager>
 #include <QOAuthHttpServerReplyHandler>
 #include <QOAuth2AuthorizationCodeFlow>
 #include <QDesktopServices>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QHash>
+#include <QTimeZone>
 
 // Microsoft Outlook 適配器
 class OutlookCalendarAdapter : public CalendarAdapter {
@@ -20,24 +27,89 @@ public:
     void authenticate() override;
     void fetchEvents(const QDateTime& start, const QDateTime& end) override;
     void fetchTasks() override;
+    void syncEvents(const QDateTime& start, const QDateTime& end, const QHash<QString, QString>& syncStates) override;
+    
+    // 以 Prefer: outlook.body-content-type="text" 取回純文字內文而非 HTML（預設啟用）
+    void setPreferTextBody(bool enabled) { m_preferTextBody = enabled; }
+    bool preferTextBody() const { return m_preferTextBody; }
+    
+    // 同時取得任務的 To Do 清單數上限
+    void setMaxParallelTaskLists(int count) { m_maxParallelTaskLists = qMax(1, count); }
+    int maxParallelTaskLists() const { return m_maxParallelTaskLists; }
+    
+    Platform platform() const override { return Platform::Outlook; }
+    QStringList syncCalendarIds() const override { return {kSyncCalendarId}; }
     
 private slots:
     void onAuthenticationGranted();
     void onAuthenticationError(const QString& error, const QString& errorDescription);
+    void onIdentityReplyFinished();
     void onEventsReplyFinished();
-    void onTasksReplyFinished();
+    void onTaskListsReplyFinished();
+    void onReplyReadyRead();
     
 private:
     QNetworkAccessManager* m_networkManager;
     QOAuth2AuthorizationCodeFlow* m_oauth;
     QOAuthHttpServerReplyHandler* m_replyHandler;
+    RequestBatcher* m_batcher;
     
     QString m_clientId;
     QString m_clientSecret;
     QString m_tenantId;
     QString m_accessToken;
+    bool m_preferTextBody = true;
+    
+    // 增量同步以整個 calendarView 為單位，只有一筆同步狀態
+    static constexpr const char* kSyncCalendarId = "calendarView";
+    
+    // 取得或同步進行中的狀態；deltaLink 失效時以同步的時間範圍重新建立基準
+    bool m_syncing = false;
+    QDateTime m_syncStart;
+    QDateTime m_syncEnd;
+    
+    // 背景解析中的單頁回應：readyRead 的片段交給工作者，元素完成即轉為事件或任務。
+    // restarted 表示 deltaLink 已失效、改由新的基準請求取代的分頁
+    struct PendingPage : EventPageJob {
+        PendingPage() : EventPageJob("value") {}
+        QList<Task> tasks;
+        QStringList taskListIds;
+        bool restarted = false;
+    };
+    using PagePtr = QSharedPointer<PendingPage>;
+    QHash<QNetworkReply*, PagePtr> m_pendingPages;
+    
+    // 分頁取得進行中的狀態；新的 fetchEvents / syncEvents 會讓舊的分頁回應失效
+    ParseReorderBuffer m_eventPages;
+    int m_fetchedEventCount = 0;
+    
+    // To Do 任務取得進行中的狀態；新的 fetchTasks 會讓舊的回應失效
+    int m_taskGeneration = 0;
+    int m_maxParallelTaskLists = RequestBatcher::kMaxPartsPerBatch;
+    QStringList m_queuedTaskLists;
+    int m_activeTaskLists = 0;
+    bool m_taskListsComplete = false;
+    int m_fetchedTaskCount = 0;
     
     void setupOAuth();
-    QList<CalendarEvent> parseEventsJson(const QByteArray& json);
-    QList<Task> parseTasksJson(const QByteArray& json);
+    CalendarEvent parseEventItem(const QJsonObject& item, const QString& ownerId) const;
+    Task parseTaskItem(const QJsonObject& item) const;
+    static QString recurrenceRuleFromGraph(const QJsonObject& recurrence);
+    static QTimeZone timeZoneFromGraph(const QString& name);
+    static QDateTime dateTimeFromGraph(const QJsonObject& dateTimeTimeZone);
+    void startEvents(const QUrl& url, bool syncing);
+    QUrl deltaBaselineUrl() const;
+    void requestEventsPage(const QUrl& url);
+    QNetworkRequest createRequest(const QUrl& url, const QByteArray& prefer = QByteArray()) const;
+    PagePtr createPage(const QString& label) const;
+    void attachPage(QNetworkReply* reply, const PagePtr& page);
+    void schedule(const QNetworkRequest& request, std::function<void(QNetworkReply*)> attach,
+                  std::function<bool()> cancelled = nullptr);
+    void closePage(QNetworkReply* reply, const PagePtr& page, const QString& errorPrefix,
+                   StreamParseJob::Completion done);
+    void deliverEventsPage(const PagePtr& page);
+    void requestTaskListsPage(const QUrl& url);
+    void requestTasksPage(const QUrl& url);
+    void startQueuedTaskLists();
+    void deliverTasksPage(const PagePtr& page);
 };
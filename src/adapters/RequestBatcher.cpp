@@ -0,0 +1,476 @@
+#include "RequestBatcher.h"
+#include "RequestScheduler.h"
+#include "ResponseParseStage.h"
+#include <QDebug>
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QNetworkRequest>
+#include <QPointer>
+#include <QTimer>
+
+namespace {
+
+int skipSpace(const QByteArray& data, int pos) {
+    while (pos < data.size() && (data[pos] == ' ' || data[pos] == '\t' || data[pos] == '\n' || data[pos] == '\r')) {
+        ++pos;
+    }
+    return pos;
+}
+
+// pos 處的 JSON 值結束後的位置，只掃描括號與字串而不建立任何物件；格式錯誤時回傳 -1
+int skipValue(const QByteArray& data, int pos) {
+    if (pos >= data.size()) {
+        return -1;
+    }
+    
+    const char first = data[pos];
+    if (first == '"') {
+        for (int i = pos + 1; i < data.size(); ++i) {
+            if (data[i] == '\\') {
+                ++i;
+            } else if (data[i] == '"') {
+                return i + 1;
+            }
+        }
+        return -1;
+    }
+    
+    if (first == '{' || first == '[') {
+        int depth = 0;
+        bool inString = false;
+        for (int i = pos; i < data.size(); ++i) {
+            const char c = data[i];
+            if (inString) {
+                if (c == '\\') {
+                    ++i;
+                } else if (c == '"') {
+                    inString = false;
+                }
+            } else if (c == '"') {
+                inString = true;
+            } else if (c == '{' || c == '[') {
+                ++depth;
+            } else if ((c == '}' || c == ']') && --depth == 0) {
+                return i + 1;
+            }
+        }
+        return -1;
+    }
+    
+    static const QByteArray delimiters(",}] \t\r\n");
+    int end = pos;
+    while (end < data.size() && !delimiters.contains(data[end])) {
+        ++end;
+    }
+    return end > pos ? end : -1;
+}
+
+// 走訪 pos 處物件的成員或陣列的元素（鍵為空），回呼收到值的位元組範圍 [begin, end)
+bool forEachChild(const QByteArray& data, int pos,
+                  const std::function<void(const QByteArray& key, int begin, int end)>& visit) {
+    pos = skipSpace(data, pos);
+    if (pos >= data.size() || (data[pos] != '{' && data[pos] != '[')) {
+        return false;
+    }
+    const bool isObject = data[pos] == '{';
+    const char close = isObject ? '}' : ']';
+    
+    pos = skipSpace(data, pos + 1);
+    if (pos < data.size() && data[pos] == close) {
+        return true;
+    }
+    
+    while (pos < data.size()) {
+        QByteArray key;
+        if (isObject) {
+            // 信封中的鍵都是不含跳脫字元的 ASCII
+            const int keyEnd = data[pos] == '"' ? skipValue(data, pos) : -1;
+            if (keyEnd < 0) {
+                return false;
+            }
+            key = data.mid(pos + 1, keyEnd - pos - 2);
+            pos = skipSpace(data, keyEnd);
+            if (pos >= data.size() || data[pos] != ':') {
+                return false;
+            }
+            pos = skipSpace(data, pos + 1);
+        }
+        
+        const int end = skipValue(data, pos);
+        if (end < 0) {
+            return false;
+        }
+        visit(key, pos, end);
+        
+        pos = skipSpace(data, end);
+        if (pos < data.size() && data[pos] == ',') {
+            pos = skipSpace(data, pos + 1);
+            continue;
+        }
+        return pos < data.size() && data[pos] == close;
+    }
+    return false;
+}
+
+// 信封中的小型值（id、status、字串內容）包成陣列交給 QJsonDocument 解析
+QJsonValue envelopeValue(const QByteArray& data, int begin, int end) {
+    return QJsonDocument::fromJson("[" + data.mid(begin, end - begin) + "]").array().at(0);
+}
+
+} // namespace
+
+RequestBatcher::RequestBatcher(Format format, QNetworkAccessManager* manager, QObject* parent)
+    : QObject(parent)
+    , m_format(format)
+    , m_manager(manager)
+    , m_endpoint(format == Format::Graph
+                 ? QUrl("https://graph.microsoft.com/v1.0/$batch")
+                 : QUrl("https://www.googleapis.com/batch/calendar/v3"))
+{
+}
+
+void RequestBatcher::enqueue(const QUrl& url, Callback callback) {
+    Part part;
+    part.id = m_nextPartId++;
+    part.url = url;
+    part.callback = std::move(callback);
+    m_queue.append(part);
+    scheduleFlush();
+}
+
+void RequestBatcher::cancelAll() {
+    ++m_generation;
+    m_queue.clear();
+    
+    const QList<QNetworkReply*> replies = m_inFlight.keys();
+    m_inFlight.clear();
+    for (QNetworkReply* reply : replies) {
+        reply->abort();
+    }
+}
+
+void RequestBatcher::scheduleFlush() {
+    // 同一輪事件迴圈中加入的子請求合併為同一批
+    if (m_flushScheduled) {
+        return;
+    }
+    m_flushScheduled = true;
+    QMetaObject::invokeMethod(this, &RequestBatcher::flush, Qt::QueuedConnection);
+}
+
+void RequestBatcher::flush() {
+    m_flushScheduled = false;
+    while (!m_queue.isEmpty()) {
+        const QList<Part> parts = m_queue.mid(0, kMaxPartsPerBatch);
+        m_queue.remove(0, parts.size());
+        sendBatch(parts);
+    }
+}
+
+QByteArray RequestBatcher::relativeTarget(const QUrl& url) const {
+    QByteArray target = url.toEncoded(QUrl::RemoveScheme | QUrl::RemoveAuthority);
+    // Graph 子請求的 url 相對於版本根目錄
+    if (m_format == Format::Graph && target.startsWith("/v1.0/")) {
+        target.remove(0, 5);
+    }
+    return target;
+}
+
+void RequestBatcher::sendBatch(const QList<Part>& parts) {
+    QNetworkRequest request;
+    request.setRawHeader("Authorization", QString("Bearer %1").arg(m_accessToken).toUtf8());
+    if (!m_userAgent.isEmpty()) {
+        request.setHeader(QNetworkRequest::UserAgentHeader, m_userAgent);
+    }
+    
+    // 只有一個子請求時直接以 GET 送出，省去批次封裝
+    const bool single = parts.size() == 1;
+    QByteArray payload;
+    if (single) {
+        request.setUrl(parts.first().url);
+        request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+    } else if (m_format == Format::Graph) {
+        request.setUrl(m_endpoint);
+        request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+        payload = encodeGraph(parts);
+    } else {
+        const QByteArray boundary = "batch_" + QByteArray::number(QDateTime::currentMSecsSinceEpoch()) +
+                                    "_" + QByteArray::number(m_batchesSent);
+        request.setUrl(m_endpoint);
+        request.setHeader(QNetworkRequest::ContentTypeHeader, "multipart/mixed; boundary=" + boundary);
+        payload = encodeGoogle(parts, boundary);
+    }
+    
+    QList<Part> sent = parts;
+    for (Part& part : sent) {
+        ++part.attempts;
+    }
+    ++m_batchesSent;
+    m_partsSent += sent.size();
+    
+    const auto send = [this, request, payload, single]() {
+        return single ? m_manager->get(request) : m_manager->post(request, payload);
+    };
+    const auto attach = [this, sent](QNetworkReply* reply) {
+        m_inFlight.insert(reply, sent);
+        connect(reply, &QNetworkReply::finished, this, &RequestBatcher::onBatchFinished);
+    };
+    if (m_schedulerBucket.isEmpty()) {
+        attach(send());
+        return;
+    }
+    
+    const int generation = m_generation;
+    RequestScheduler::Request scheduled;
+    scheduled.bucket = m_schedulerBucket;
+    scheduled.context = this;
+    scheduled.send = send;
+    scheduled.attach = attach;
+    scheduled.detach = [this](QNetworkReply* reply) {
+        m_inFlight.remove(reply);
+    };
+    scheduled.cancelled = [this, generation]() {
+        return generation != m_generation;
+    };
+    RequestScheduler::instance()->submit(scheduled);
+}
+
+void RequestBatcher::onBatchFinished() {
+    QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
+    if (!reply) return;
+    reply->deleteLater();
+    
+    // cancelAll 之後的回應不再分派
+    if (!m_inFlight.contains(reply)) {
+        return;
+    }
+    const QList<Part> parts = m_inFlight.take(reply);
+    
+    bool ok = false;
+    const int retryAfter = reply->rawHeader("Retry-After").toInt(&ok);
+    BatchOutcome outcome;
+    outcome.status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    outcome.retryAfterSeconds = ok ? retryAfter : -1;
+    outcome.failed = reply->error() != QNetworkReply::NoError;
+    outcome.error = reply->errorString();
+    
+    if (parts.size() == 1) {
+        PartResponse response;
+        response.id = parts.first().id;
+        response.status = outcome.status;
+        response.body = reply->readAll();
+        response.retryAfterSeconds = outcome.retryAfterSeconds;
+        response.retried = !m_schedulerBucket.isEmpty();
+        dispatch(parts, {response}, outcome);
+        return;
+    }
+    if (outcome.failed) {
+        dispatch(parts, {}, outcome);
+        return;
+    }
+    
+    // 拆解整個批次回應交給解析工作者，GUI 執行緒只負責收資料與分派
+    const QByteArray body = reply->readAll();
+    QByteArray boundary;
+    if (m_format == Format::Google) {
+        const QByteArray contentType = reply->header(QNetworkRequest::ContentTypeHeader).toByteArray();
+        const int index = contentType.indexOf("boundary=");
+        boundary = index >= 0 ? contentType.mid(index + 9).split(';').first().replace('"', "").trimmed() : QByteArray();
+    }
+    
+    const Format format = m_format;
+    const int generation = m_generation;
+    QPointer<RequestBatcher> self(this);
+    ResponseParseStage::pool()->start([self, format, body, boundary, parts, outcome, generation]() {
+        const QList<PartResponse> decoded = format == Format::Graph ? decodeGraph(body)
+                                                                     : decodeGoogle(body, boundary);
+        if (!self) {
+            return;
+        }
+        RequestBatcher* batcher = self.data();
+        QMetaObject::invokeMethod(batcher, [batcher, parts, decoded, outcome, generation]() {
+            // 拆解期間呼叫過 cancelAll 時不再分派
+            if (generation == batcher->m_generation) {
+                batcher->dispatch(parts, decoded, outcome);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void RequestBatcher::dispatch(const QList<Part>& parts, const QList<PartResponse>& decoded,
+                              const BatchOutcome& outcome) {
+    QHash<int, PartResponse> responses;
+    for (const PartResponse& response : decoded) {
+        responses.insert(response.id, response);
+    }
+    
+    // 整批失敗時各子請求沿用批次的狀態碼；批次成功卻缺少的回應視為可重試
+    for (const Part& part : parts) {
+        PartResponse response = responses.value(part.id);
+        if (!responses.contains(part.id)) {
+            response.id = part.id;
+            response.status = outcome.failed ? outcome.status : 0;
+            response.retryAfterSeconds = outcome.retryAfterSeconds;
+            response.retried = outcome.failed && !m_schedulerBucket.isEmpty();
+        }
+        complete(part, response, outcome.error);
+    }
+}
+
+bool RequestBatcher::isRetryable(int status) {
+    return status == 0 || status == 429 || status == 500 || status == 502 || status == 503 || status == 504;
+}
+
+void RequestBatcher::complete(const Part& part, const PartResponse& response, const QString& batchError) {
+    if (!response.retried && isRetryable(response.status) && part.attempts < m_maxAttempts) {
+        // 只重送失敗的子請求；優先採用伺服器指定的 Retry-After，否則指數退避
+        ++m_partsRetried;
+        const int delayMs = response.retryAfterSeconds >= 0
+            ? response.retryAfterSeconds * 1000 : 1000 << (part.attempts - 1);
+        const int generation = m_generation;
+        qDebug() << "子請求" << part.id << "狀態" << response.status << "，" << delayMs << "ms 後重試";
+        QTimer::singleShot(delayMs, this, [this, part, generation]() {
+            if (generation != m_generation) {
+                return;
+            }
+            m_queue.append(part);
+            scheduleFlush();
+        });
+        return;
+    }
+    
+    Response result;
+    result.status = response.status;
+    result.body = response.body;
+    if (response.status == 0) {
+        result.error = batchError;
+    } else if (response.status < 200 || response.status >= 300) {
+        result.error = QString("HTTP %1").arg(response.status);
+    }
+    part.callback(result);
+}
+
+QByteArray RequestBatcher::encodeGraph(const QList<Part>& parts) const {
+    QJsonArray requests;
+    for (const Part& part : parts) {
+        QJsonObject request;
+        request["id"] = QString::number(part.id);
+        request["method"] = "GET";
+        request["url"] = QString::fromUtf8(relativeTarget(part.url));
+        requests.append(request);
+    }
+    
+    QJsonObject root;
+    root["requests"] = requests;
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+QByteArray RequestBatcher::encodeGoogle(const QList<Part>& parts, const QByteArray& boundary) const {
+    QByteArray body;
+    for (const Part& part : parts) {
+        body += "--" + boundary + "\r\n";
+        body += "Content-Type: application/http\r\n";
+        body += "Content-ID: <" + QByteArray::number(part.id) + ">\r\n\r\n";
+        body += "GET " + relativeTarget(part.url) + " HTTP/1.1\r\n\r\n";
+    }
+    body += "--" + boundary + "--\r\n";
+    return body;
+}
+
+QList<RequestBatcher::PartResponse> RequestBatcher::decodeGraph(const QByteArray& body) {
+    // 只掃描信封的結構；子回應的 JSON 內容以原始位元組切出，由子請求的解析工作者解析，
+    // 不必先建成 QJsonObject 再重新序列化
+    QList<PartResponse> responses;
+    forEachChild(body, 0, [&](const QByteArray& key, int begin, int) {
+        if (key != "responses") {
+            return;
+        }
+        forEachChild(body, begin, [&](const QByteArray&, int itemBegin, int) {
+            PartResponse response;
+            forEachChild(body, itemBegin, [&](const QByteArray& field, int valueBegin, int valueEnd) {
+                if (field == "id") {
+                    response.id = envelopeValue(body, valueBegin, valueEnd).toString().toInt();
+                } else if (field == "status") {
+                    response.status = envelopeValue(body, valueBegin, valueEnd).toInt();
+                } else if (field == "body") {
+                    // 非 JSON 的內容以字串表示
+                    response.body = body[valueBegin] == '"'
+                        ? envelopeValue(body, valueBegin, valueEnd).toString().toUtf8()
+                        : body.mid(valueBegin, valueEnd - valueBegin);
+                } else if (field == "headers") {
+                    const QJsonObject headers = envelopeValue(body, valueBegin, valueEnd).toObject();
+                    if (headers.contains("Retry-After")) {
+                        response.retryAfterSeconds = headers["Retry-After"].toString().toInt();
+                    }
+                }
+            });
+            responses.append(response);
+        });
+    });
+    return responses;
+}
+
+QByteArray RequestBatcher::headerValue(const QByteArray& headers, const QByteArray& name) {
+    const QByteArray prefix = name.toLower() + ':';
+    for (const QByteArray& line : headers.split('\n')) {
+        const QByteArray trimmed = line.trimmed();
+        if (trimmed.toLower().startsWith(prefix)) {
+            return trimmed.mid(prefix.size()).trimmed();
+        }
+    }
+    return QByteArray();
+}
+
+QList<RequestBatcher::PartResponse> RequestBatcher::decodeGoogle(const QByteArray& body, const QByteArray& boundary) {
+    QList<PartResponse> responses;
+    if (boundary.isEmpty()) {
+        return responses;
+    }
+    
+    // 每個部分：外層標頭（Content-ID）、空行、HTTP 狀態列與標頭、空行、內容
+    const QByteArray delimiter = "--" + boundary;
+    int position = body.indexOf(delimiter);
+    while (position >= 0) {
+        const int start = position + delimiter.size();
+        if (body.mid(start, 2) == "--") {
+            break;
+        }
+        const int next = body.indexOf(delimiter, start);
+        if (next < 0) {
+            break;
+        }
+        const QByteArray section = body.mid(start, next - start);
+        position = next;
+        
+        const int outerEnd = section.indexOf("\r\n\r\n");
+        if (outerEnd < 0) {
+            continue;
+        }
+        // 回應的 Content-ID 為 <response-原本的 id>
+        QByteArray contentId = headerValue(section.left(outerEnd), "Content-ID");
+        contentId.replace('<', "").replace('>', "");
+        contentId = contentId.mid(contentId.lastIndexOf('-') + 1);
+        
+        const QByteArray http = section.mid(outerEnd + 4);
+        const int statusEnd = http.indexOf("\r\n");
+        const int headerEnd = http.indexOf("\r\n\r\n");
+        const QList<QByteArray> statusLine = http.left(statusEnd).split(' ');
+        
+        PartResponse response;
+        response.id = contentId.toInt();
+        response.status = statusLine.size() > 1 ? statusLine[1].toInt() : 0;
+        if (headerEnd >= 0) {
+            bool ok = false;
+            const int retryAfter = headerValue(http.left(headerEnd), "Retry-After").toInt(&ok);
+            response.retryAfterSeconds = ok ? retryAfter : -1;
+            response.body = http.mid(headerEnd + 4);
+            if (response.body.endsWith("\r\n")) {
+                response.body.chop(2);
+            }
+        }
+        responses.append(response);
+    }
+    return responses;
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <QObject>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QUrl>
+#include <QList>
+#include <QHash>
+#include <QString>
+#include <functional>
+
+// 請求批次層 - 同一輪事件迴圈中加入的 GET 子請求打包成一個批次請求送出：
+// Microsoft Graph 使用 JSON $batch，Google 使用 multipart/mixed 批次端點。
+// 回應依子請求 id 分派回各自的回呼；被節流或暫時失敗的子請求個別重試。
+// 批次回應在解析工作者（ResponseParseStage）上拆解，子回應的內容以位元組原樣交給回呼。
+class RequestBatcher : public QObject {
+    Q_OBJECT
+    
+public:
+    enum class Format { Graph, Google };
+    
+    // 子請求的結果；status 為 0 表示批次請求本身失敗（已用盡重試）
+    struct Response {
+        int status = 0;
+        QByteArray body;
+        QString error;
+    };
+    using Callback = std::function<void(const Response& response)>;
+    
+    // Graph $batch 每批最多 20 個子請求；Google 上限較高，採用相同大小
+    static constexpr int kMaxPartsPerBatch = 20;
+    
+    RequestBatcher(Format format, QNetworkAccessManager* manager, QObject* parent = nullptr);
+    
+    void setAccessToken(const QString& token) { m_accessToken = token; }
+    void setEndpoint(const QUrl& endpoint) { m_endpoint = endpoint; }
+    void setMaxAttempts(int attempts) { m_maxAttempts = qMax(1, attempts); }
+    void setUserAgent(const QByteArray& userAgent) { m_userAgent = userAgent; }
+    
+    // 設定後批次請求經由 RequestScheduler 的這個令牌桶送出；整個批次的暫時失敗由排程器重送
+    void setSchedulerBucket(const QString& bucket) { m_schedulerBucket = bucket; }
+    
+    // url 必須位於服務根目錄之下（Graph 為 /v1.0，Google 為 googleapis.com）
+    void enqueue(const QUrl& url, Callback callback);
+    
+    // 捨棄所有尚未完成的子請求，其回呼不會被呼叫
+    void cancelAll();
+    
+    int batchesSent() const { return m_batchesSent; }
+    int partsSent() const { return m_partsSent; }
+    int partsRetried() const { return m_partsRetried; }
+    
+private slots:
+    void flush();
+    void onBatchFinished();
+    
+private:
+    struct Part {
+        int id = 0;
+        QUrl url;
+        Callback callback;
+        int attempts = 0;
+    };
+    
+    struct PartResponse {
+        int id = 0;
+        int status = 0;
+        QByteArray body;
+        int retryAfterSeconds = -1;
+        bool retried = false;   // 排程器已重送過整個請求，不再逐一重試
+    };
+    
+    // 批次請求本身的結果，子回應缺少時沿用
+    struct BatchOutcome {
+        int status = 0;
+        int retryAfterSeconds = -1;
+        bool failed = false;
+        QString error;
+    };
+    
+    void scheduleFlush();
+    void sendBatch(const QList<Part>& parts);
+    void dispatch(const QList<Part>& parts, const QList<PartResponse>& decoded, const BatchOutcome& outcome);
+    void complete(const Part& part, const PartResponse& response, const QString& batchError);
+    static bool isRetryable(int status);
+    QByteArray relativeTarget(const QUrl& url) const;
+    
+    QByteArray encodeGraph(const QList<Part>& parts) const;
+    QByteArray encodeGoogle(const QList<Part>& parts, const QByteArray& boundary) const;
+    static QList<PartResponse> decodeGraph(const QByteArray& body);
+    static QList<PartResponse> decodeGoogle(const QByteArray& body, const QByteArray& boundary);
+    static QByteArray headerValue(const QByteArray& headers, const QByteArray& name);
+    
+    Format m_format;
+    QNetworkAccessManager* m_manager;
+    QUrl m_endpoint;
+    QString m_accessToken;
+    QByteArray m_userAgent;
+    QString m_schedulerBucket;
+    int m_maxAttempts = 3;
+    
+    int m_nextPartId = 1;
+    int m_generation = 0;
+    QList<Part> m_queue;
+    bool m_flushScheduled = false;
+    QHash<QNetworkReply*, QList<Part>> m_inFlight;
+    
+    int m_batchesSent = 0;
+    int m_partsSent = 0;
+    int m_partsRetried = 0;
+};
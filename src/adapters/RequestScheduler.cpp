@@ -0,0 +1,237 @@
+#include "RequestScheduler.h"
+#include <QDebug>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QNetworkRequest>
+#include <QRandomGenerator>
+#include <QSet>
+#include <cmath>
+
+RequestScheduler* RequestScheduler::instance() {
+    // 所有適配器共用同一個排程器，才能一起限制同時進行的請求數
+    static RequestScheduler* scheduler = new RequestScheduler(QCoreApplication::instance());
+    return scheduler;
+}
+
+RequestScheduler::RequestScheduler(QObject* parent)
+    : QObject(parent)
+{
+    m_clock.start();
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QTimer::timeout, this, &RequestScheduler::pump);
+}
+
+void RequestScheduler::setRateLimit(const QString& name, double requestsPerSecond, int burst) {
+    Bucket& target = bucket(name);
+    target.rate = qMax(0.01, requestsPerSecond);
+    target.capacity = qMax(1, burst);
+    target.tokens = qMin(target.tokens, target.capacity);
+    pump();
+}
+
+void RequestScheduler::setDefaultRateLimit(double requestsPerSecond, int burst) {
+    m_defaultRate = qMax(0.01, requestsPerSecond);
+    m_defaultBurst = qMax(1, burst);
+}
+
+void RequestScheduler::submit(const Request& request) {
+    Pending pending;
+    pending.request = request;
+    m_queue.append(pending);
+    pump();
+}
+
+int RequestScheduler::queueDepth(const QString& name) const {
+    int depth = 0;
+    for (const Pending& pending : m_queue) {
+        if (pending.request.bucket == name) {
+            ++depth;
+        }
+    }
+    return depth;
+}
+
+RequestScheduler::Bucket& RequestScheduler::bucket(const QString& name) {
+    auto it = m_buckets.find(name);
+    if (it == m_buckets.end()) {
+        Bucket created;
+        created.rate = m_defaultRate;
+        created.capacity = m_defaultBurst;
+        created.tokens = m_defaultBurst;
+        created.refilledAt = m_clock.elapsed();
+        it = m_buckets.insert(name, created);
+    }
+    return it.value();
+}
+
+qint64 RequestScheduler::readyAt(Bucket& target, qint64 now) {
+    target.tokens = qMin(target.capacity, target.tokens + (now - target.refilledAt) * target.rate / 1000.0);
+    target.refilledAt = now;
+    
+    if (now < target.blockedUntil) {
+        return target.blockedUntil;
+    }
+    if (target.tokens >= 1.0) {
+        return now;
+    }
+    return now + static_cast<qint64>(std::ceil((1.0 - target.tokens) * 1000.0 / target.rate));
+}
+
+void RequestScheduler::pump() {
+    const qint64 now = m_clock.elapsed();
+    qint64 nextWake = -1;
+    const auto wakeAt = [&nextWake](qint64 time) {
+        nextWake = nextWake < 0 ? time : qMin(nextWake, time);
+    };
+    
+    // 同一個桶依送出順序；等待中的桶不擋住其他帳號或 API 的請求
+    QSet<QString> waiting;
+    int index = 0;
+    while (index < m_queue.size() && m_inFlight.size() < m_maxInFlight) {
+        Pending& pending = m_queue[index];
+        if (!pending.request.context || (pending.request.cancelled && pending.request.cancelled())) {
+            m_queue.removeAt(index);
+            continue;
+        }
+        
+        // 退避中的重送只延後自己
+        if (pending.notBefore > now) {
+            wakeAt(pending.notBefore);
+            ++index;
+            continue;
+        }
+        if (waiting.contains(pending.request.bucket)) {
+            ++index;
+            continue;
+        }
+        
+        Bucket& target = bucket(pending.request.bucket);
+        const qint64 ready = readyAt(target, now);
+        if (ready > now) {
+            if (!pending.counted) {
+                pending.counted = true;
+                ++m_stats.delayed;
+            }
+            waiting.insert(pending.request.bucket);
+            wakeAt(ready);
+            ++index;
+            continue;
+        }
+        
+        target.tokens -= 1.0;
+        dispatch(m_queue.takeAt(index));
+    }
+    
+    if (nextWake >= 0) {
+        m_timer.start(static_cast<int>(qMax<qint64>(1, nextWake - now)));
+    }
+}
+
+void RequestScheduler::dispatch(Pending pending) {
+    ++pending.attempts;
+    ++m_stats.sent;
+    
+    QNetworkReply* reply = pending.request.send();
+    m_inFlight.insert(reply, pending);
+    // 先於適配器連接 finished，重送時可在適配器的槽執行前切斷
+    connect(reply, &QNetworkReply::finished, this, &RequestScheduler::onReplyFinished);
+    pending.request.attach(reply);
+}
+
+int RequestScheduler::retryDelay(QNetworkReply* reply, int attempts, bool* throttled) const {
+    *throttled = false;
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    
+    bool retryable = false;
+    if (status == 429) {
+        *throttled = true;
+        retryable = true;
+    } else if (status == 403) {
+        // Google 以 403 rateLimitExceeded / userRateLimitExceeded 表示超過配額；錯誤內容留給適配器讀取
+        *throttled = reply->peek(4096).contains("ateLimitExceeded");
+        retryable = *throttled;
+    } else if (status == 500 || status == 502 || status == 503 || status == 504) {
+        retryable = true;
+    } else if (status == 0) {
+        switch (reply->error()) {
+        case QNetworkReply::RemoteHostClosedError:
+        case QNetworkReply::TimeoutError:
+        case QNetworkReply::TemporaryNetworkFailureError:
+        case QNetworkReply::NetworkSessionFailedError:
+        case QNetworkReply::ProxyTimeoutError:
+        case QNetworkReply::UnknownNetworkError:
+            retryable = true;
+            break;
+        default:
+            break;
+        }
+    }
+    if (!retryable) {
+        return -1;
+    }
+    
+    // 優先採用 Retry-After（秒數或 HTTP 日期）
+    const QByteArray retryAfter = reply->rawHeader("Retry-After").trimmed();
+    if (!retryAfter.isEmpty()) {
+        bool ok = false;
+        const int seconds = retryAfter.toInt(&ok);
+        if (ok) {
+            return qMax(0, seconds) * 1000;
+        }
+        const QDateTime when = QDateTime::fromString(QString::fromLatin1(retryAfter), Qt::RFC2822Date);
+        if (when.isValid()) {
+            return static_cast<int>(qBound<qint64>(0, QDateTime::currentDateTimeUtc().msecsTo(when), 3600000));
+        }
+    }
+    
+    // 指數退避加上隨機抖動，避免多個請求同時重送
+    const int ceiling = qMin(30000, 500 << qMin(attempts - 1, 6));
+    return ceiling / 2 + static_cast<int>(QRandomGenerator::global()->bounded(ceiling / 2 + 1));
+}
+
+void RequestScheduler::onReplyFinished() {
+    QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
+    if (!reply) return;
+    
+    auto it = m_inFlight.find(reply);
+    if (it == m_inFlight.end()) {
+        return;
+    }
+    Pending pending = it.value();
+    m_inFlight.erase(it);
+    QMetaObject::invokeMethod(this, &RequestScheduler::pump, Qt::QueuedConnection);
+    
+    bool throttled = false;
+    const int delay = retryDelay(reply, pending.attempts, &throttled);
+    if (throttled) {
+        ++m_stats.throttled;
+    }
+    if (delay < 0 || !pending.request.context) {
+        return;
+    }
+    
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (pending.attempts >= m_maxAttempts) {
+        ++m_stats.gaveUp;
+        qDebug() << "請求" << reply->url().path() << "重送" << pending.attempts - 1 << "次後仍失敗，狀態" << status;
+        return;
+    }
+    
+    // 適配器的 finished 槽不會收到這個回應，改由下一次嘗試的回應取代
+    disconnect(reply, nullptr, pending.request.context, nullptr);
+    if (pending.request.detach) {
+        pending.request.detach(reply);
+    }
+    reply->deleteLater();
+    
+    ++m_stats.retried;
+    pending.notBefore = m_clock.elapsed() + delay;
+    pending.counted = false;
+    if (throttled || reply->hasRawHeader("Retry-After")) {
+        // 伺服器要求暫停時，同一帳號與 API 的其他請求一起等待
+        Bucket& target = bucket(pending.request.bucket);
+        target.blockedUntil = qMax(target.blockedUntil, pending.notBefore);
+    }
+    qDebug() << "請求" << reply->url().path() << "狀態" << status << "，" << delay << "ms 後重送（佇列" << m_queue.size() + 1 << "個）";
+    m_queue.prepend(pending);
+}
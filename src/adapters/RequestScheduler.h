@@ -0,0 +1,89 @@
+#pragma once
+
+#include <QObject>
+#include <QNetworkReply>
+#include <QPointer>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QHash>
+#include <QList>
+#include <functional>
+
+// 請求排程器 - 所有適配器共用。每個 (帳號, API) 各有一個令牌桶限制送出速率，
+// 全域限制同時進行的請求數；429 / 5xx 與暫時性網路錯誤依 Retry-After 或
+// 加上隨機抖動的指數退避重送，重送對適配器透明，用盡次數後才交給原本的錯誤處理。
+class RequestScheduler : public QObject {
+    Q_OBJECT
+    
+public:
+    struct Request {
+        QString bucket;                                  // 帳號/API，例如 "google:<clientId>/calendar"
+        QPointer<QObject> context;                       // 訊號接收者；被刪除時請求一併取消
+        std::function<QNetworkReply*()> send;            // 每次嘗試都重新送出
+        std::function<void(QNetworkReply*)> attach;      // 送出後接上 readyRead / finished 等訊號
+        std::function<void(QNetworkReply*)> detach;      // 重送前捨棄舊回應時清理（可為空）
+        std::function<bool()> cancelled;                 // 送出前檢查，回傳 true 時直接捨棄（可為空）
+    };
+    
+    struct Stats {
+        int sent = 0;        // 實際送出的請求（含重送）
+        int retried = 0;     // 因暫時失敗而重送的次數
+        int throttled = 0;   // 伺服器回應節流（429 / 403 rateLimitExceeded）的次數
+        int delayed = 0;     // 因令牌桶或 Retry-After 而延後送出的次數
+        int gaveUp = 0;      // 用盡重送次數後交回錯誤的請求
+    };
+    
+    static RequestScheduler* instance();
+    
+    // 令牌桶：平均每秒 requestsPerSecond 個請求，最多累積 burst 個
+    void setRateLimit(const QString& bucket, double requestsPerSecond, int burst);
+    void setDefaultRateLimit(double requestsPerSecond, int burst);
+    void setMaxInFlight(int count) { m_maxInFlight = qMax(1, count); pump(); }
+    void setMaxAttempts(int attempts) { m_maxAttempts = qMax(1, attempts); }
+    
+    void submit(const Request& request);
+    
+    int queueDepth() const { return m_queue.size(); }
+    int queueDepth(const QString& bucket) const;
+    int inFlight() const { return m_inFlight.size(); }
+    Stats stats() const { return m_stats; }
+    
+private slots:
+    void pump();
+    void onReplyFinished();
+    
+private:
+    struct Bucket {
+        double rate = 10.0;
+        double capacity = 10.0;
+        double tokens = 10.0;
+        qint64 refilledAt = 0;
+        qint64 blockedUntil = 0;   // Retry-After 期間整個桶暫停送出
+    };
+    
+    struct Pending {
+        Request request;
+        int attempts = 0;
+        qint64 notBefore = 0;
+        bool counted = false;      // 已計入 delayed
+    };
+    
+    explicit RequestScheduler(QObject* parent = nullptr);
+    
+    Bucket& bucket(const QString& name);
+    qint64 readyAt(Bucket& bucket, qint64 now);
+    void dispatch(Pending pending);
+    int retryDelay(QNetworkReply* reply, int attempts, bool* throttled) const;
+    
+    QElapsedTimer m_clock;
+    QTimer m_timer;
+    QHash<QString, Bucket> m_buckets;
+    double m_defaultRate = 10.0;
+    int m_defaultBurst = 10;
+    int m_maxInFlight = 8;
+    int m_maxAttempts = 4;
+    
+    QList<Pending> m_queue;
+    QHash<QNetworkReply*, Pending> m_inFlight;
+    Stats m_stats;
+};
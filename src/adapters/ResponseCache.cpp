@@ -0,0 +1,223 @@
+#include "ResponseCache.h"
+#include "ResponseParseStage.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QCryptographicHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+
+ResponseCache::ResponseCache(const QString& directory)
+    : m_directory(directory.isEmpty()
+                  ? QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/responses"
+                  : directory)
+    , m_parsed(256)
+{
+    QDir().mkpath(m_directory);
+    prune();
+}
+
+ResponseCache::~ResponseCache() {
+    // 未完成的暫存檔不保留
+    for (const PendingWrite& pending : std::as_const(m_writes)) {
+        if (pending.file) {
+            pending.file->remove();
+            delete pending.file;
+        }
+    }
+}
+
+QString ResponseCache::key(const QUrl& url) const {
+    const QByteArray source = m_account.toUtf8() + '\n' + url.toEncoded();
+    return QString::fromLatin1(QCryptographicHash::hash(source, QCryptographicHash::Sha1).toHex());
+}
+
+QString ResponseCache::bodyPath(const QString& key) const {
+    return m_directory + "/" + key + ".body";
+}
+
+QString ResponseCache::metaPath(const QString& key) const {
+    return m_directory + "/" + key + ".meta";
+}
+
+bool ResponseCache::loadValidators(const QString& key, Validators* validators) {
+    auto it = m_validators.constFind(key);
+    if (it == m_validators.constEnd()) {
+        // 第一次用到時才從磁碟讀取
+        QFile file(metaPath(key));
+        if (!file.open(QIODevice::ReadOnly) || !QFile::exists(bodyPath(key))) {
+            return false;
+        }
+        const QJsonObject meta = QJsonDocument::fromJson(file.readAll()).object();
+        Validators loaded;
+        loaded.etag = meta["etag"].toString().toUtf8();
+        loaded.lastModified = meta["lastModified"].toString().toUtf8();
+        loaded.storedAt = QDateTime::fromString(meta["storedAt"].toString(), Qt::ISODate);
+        it = m_validators.insert(key, loaded);
+    }
+    
+    *validators = it.value();
+    return !validators->etag.isEmpty() || !validators->lastModified.isEmpty();
+}
+
+bool ResponseCache::prepare(QNetworkRequest& request, const QString& key) {
+    Validators validators;
+    if (!loadValidators(key, &validators)) {
+        return false;
+    }
+    
+    if (!validators.etag.isEmpty()) {
+        request.setRawHeader("If-None-Match", validators.etag);
+    }
+    if (!validators.lastModified.isEmpty()) {
+        request.setRawHeader("If-Modified-Since", validators.lastModified);
+    }
+    return true;
+}
+
+void ResponseCache::track(QNetworkReply* reply, const QString& key) {
+    PendingWrite pending;
+    pending.key = key;
+    m_writes.insert(reply, pending);
+}
+
+void ResponseCache::write(QNetworkReply* reply, const QByteArray& chunk) {
+    auto it = m_writes.find(reply);
+    if (it == m_writes.end()) {
+        return;
+    }
+    
+    PendingWrite& pending = it.value();
+    if (!pending.started) {
+        // 第一個片段到達時標頭已齊全；沒有驗證資訊或禁止儲存的回應不快取
+        pending.started = true;
+        const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        const bool hasValidators = reply->hasRawHeader("ETag") || reply->hasRawHeader("Last-Modified");
+        const bool noStore = reply->rawHeader("Cache-Control").contains("no-store");
+        pending.cacheable = status == 200 && hasValidators && !noStore;
+        if (pending.cacheable) {
+            pending.file = new QFile(bodyPath(pending.key) + ".part");
+            if (!pending.file->open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+                qDebug() << "無法寫入回應快取:" << pending.file->fileName();
+                delete pending.file;
+                pending.file = nullptr;
+                pending.cacheable = false;
+            }
+        }
+    }
+    
+    if (pending.file && !chunk.isEmpty()) {
+        pending.file->write(chunk);
+    }
+}
+
+void ResponseCache::commit(QNetworkReply* reply) {
+    if (!m_writes.contains(reply)) {
+        return;
+    }
+    // 沒有任何片段的回應也要判斷一次標頭
+    write(reply, QByteArray());
+    const PendingWrite pending = m_writes.take(reply);
+    ++m_stats.misses;
+    if (!pending.file) {
+        return;
+    }
+    
+    pending.file->close();
+    const QString path = bodyPath(pending.key);
+    m_diskBytes -= QFileInfo(path).size();
+    QFile::remove(path);
+    const bool renamed = pending.file->rename(path);
+    delete pending.file;
+    if (!renamed) {
+        return;
+    }
+    m_diskBytes += QFileInfo(path).size();
+    
+    Validators validators;
+    validators.etag = reply->rawHeader("ETag");
+    validators.lastModified = reply->rawHeader("Last-Modified");
+    validators.storedAt = QDateTime::currentDateTimeUtc();
+    m_validators.insert(pending.key, validators);
+    // 舊的解析結果已不對應磁碟上的內容
+    m_parsed.remove(pending.key);
+    
+    QJsonObject meta;
+    meta["url"] = QString::fromUtf8(reply->url().toEncoded());
+    meta["etag"] = QString::fromUtf8(validators.etag);
+    meta["lastModified"] = QString::fromUtf8(validators.lastModified);
+    meta["storedAt"] = validators.storedAt.toString(Qt::ISODate);
+    QFile file(metaPath(pending.key));
+    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        file.write(QJsonDocument(meta).toJson(QJsonDocument::Compact));
+    }
+    file.close();
+    
+    if (m_diskBytes > m_maxDiskBytes) {
+        prune();
+    }
+}
+
+void ResponseCache::discard(QNetworkReply* reply) {
+    const PendingWrite pending = m_writes.take(reply);
+    if (pending.file) {
+        pending.file->remove();
+        delete pending.file;
+    }
+}
+
+QByteArray ResponseCache::body(const QString& key) const {
+    QFile file(bodyPath(key));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    return file.readAll();
+}
+
+void ResponseCache::remove(const QString& key) {
+    m_validators.remove(key);
+    m_parsed.remove(key);
+    m_diskBytes -= QFileInfo(bodyPath(key)).size();
+    QFile::remove(bodyPath(key));
+    QFile::remove(metaPath(key));
+}
+
+void ResponseCache::setLimits(qint64 maxDiskBytes, int maxAgeDays) {
+    m_maxDiskBytes = qMax<qint64>(0, maxDiskBytes);
+    m_maxAgeDays = qMax(1, maxAgeDays);
+    prune();
+}
+
+void ResponseCache::prune() {
+    // 由新到舊累計大小，超過總量或保存期限的回應連同驗證資訊一併移除
+    const QDateTime oldest = QDateTime::currentDateTimeUtc().addDays(-m_maxAgeDays);
+    const QFileInfoList bodies = QDir(m_directory).entryInfoList({"*.body"}, QDir::Files, QDir::Time);
+    
+    qint64 kept = 0;
+    for (const QFileInfo& info : bodies) {
+        if (kept + info.size() <= m_maxDiskBytes && info.lastModified().toUTC() >= oldest) {
+            kept += info.size();
+            continue;
+        }
+        // 記憶體中的解析結果保留，已帶條件式標頭送出的請求收到 304 時仍可沿用
+        const QString key = info.completeBaseName();
+        m_validators.remove(key);
+        QFile::remove(info.filePath());
+        QFile::remove(metaPath(key));
+        ++m_stats.evicted;
+    }
+    m_diskBytes = kept;
+}
+
+void ResponseCache::storeParsed(const QString& key, const QSharedPointer<StreamParseJob>& job) {
+    m_parsed.insert(key, new QSharedPointer<StreamParseJob>(job));
+}
+
+QSharedPointer<StreamParseJob> ResponseCache::parsed(const QString& key) const {
+    const QSharedPointer<StreamParseJob>* job = m_parsed.object(key);
+    return job ? *job : QSharedPointer<StreamParseJob>();
+}
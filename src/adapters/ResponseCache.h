@@ -0,0 +1,92 @@
+#pragma once
+
+#include <QString>
+#include <QByteArray>
+#include <QDateTime>
+#include <QHash>
+#include <QCache>
+#include <QSharedPointer>
+#include <QUrl>
+
+class QFile;
+class QNetworkReply;
+class QNetworkRequest;
+class StreamParseJob;
+
+// HTTP 回應快取 - 以 (帳號, URL) 為鍵把回應內容與 ETag / Last-Modified 存在磁碟上，
+// 之後的請求帶上 If-None-Match / If-Modified-Since。收到 304 時沿用記憶體中的
+// 解析結果，完全略過解析；記憶體中沒有時（例如重新啟動後）改為解析磁碟上的內容。
+// 磁碟上的內容有總大小與保存期限上限，超過時先移除最早下載的回應。
+class ResponseCache {
+public:
+    struct Stats {
+        int hits = 0;         // 304，沿用快取內容
+        int misses = 0;       // 200，重新下載
+        int staleServed = 0;  // stale-while-revalidate 先送出的快取內容
+        int evicted = 0;      // 因超過大小或保存期限而移除的回應
+    };
+    
+    static constexpr qint64 kDefaultMaxDiskBytes = 64LL * 1024 * 1024;
+    static constexpr int kDefaultMaxAgeDays = 30;
+    
+    // directory 為空時使用系統的快取目錄
+    explicit ResponseCache(const QString& directory = QString());
+    ~ResponseCache();
+    
+    // 同一 URL 在不同帳號下是不同的回應
+    void setAccount(const QString& account) { m_account = account; }
+    QString key(const QUrl& url) const;
+    
+    // 有快取內容時加上條件式標頭，回傳是否加上
+    bool prepare(QNetworkRequest& request, const QString& key);
+    
+    // 追蹤 200 回應的內容：write 逐段寫入暫存檔，commit 時才取代舊的快取
+    void track(QNetworkReply* reply, const QString& key);
+    void write(QNetworkReply* reply, const QByteArray& chunk);
+    void commit(QNetworkReply* reply);
+    void discard(QNetworkReply* reply);
+    
+    QByteArray body(const QString& key) const;
+    void remove(const QString& key);
+    
+    // 調整上限後立即清理；建構時與每次寫入超過上限時也會清理
+    void setLimits(qint64 maxDiskBytes, int maxAgeDays);
+    qint64 diskBytes() const { return m_diskBytes; }
+    
+    // 解析結果只保留在記憶體中（最近使用的頁面）
+    void storeParsed(const QString& key, const QSharedPointer<StreamParseJob>& job);
+    QSharedPointer<StreamParseJob> parsed(const QString& key) const;
+    
+    void recordHit() { ++m_stats.hits; }
+    void recordStaleServed() { ++m_stats.staleServed; }
+    Stats stats() const { return m_stats; }
+    
+private:
+    struct Validators {
+        QByteArray etag;
+        QByteArray lastModified;
+        QDateTime storedAt;
+    };
+    
+    struct PendingWrite {
+        QString key;
+        QFile* file = nullptr;
+        bool cacheable = false;
+        bool started = false;
+    };
+    
+    QString bodyPath(const QString& key) const;
+    QString metaPath(const QString& key) const;
+    bool loadValidators(const QString& key, Validators* validators);
+    void prune();
+    
+    QString m_directory;
+    QString m_account;
+    QHash<QString, Validators> m_validators;
+    QHash<QNetworkReply*, PendingWrite> m_writes;
+    QCache<QString, QSharedPointer<StreamParseJob>> m_parsed;
+    Stats m_stats;
+    qint64 m_maxDiskBytes = kDefaultMaxDiskBytes;
+    int m_maxAgeDays = kDefaultMaxAgeDays;
+    qint64 m_diskBytes = 0;
+};
@@ -0,0 +1,155 @@
+#include "ResponseParseStage.h"
+#include <QMutexLocker>
+#include <QThread>
+
+QThreadPool* ResponseParseStage::pool() {
+    // 與 QtConcurrent 的全域執行緒池分開，背景搜尋不會被大量回應擠住
+    static QThreadPool* instance = [] {
+        QThreadPool* threadPool = new QThreadPool;
+        threadPool->setMaxThreadCount(qMax(1, QThread::idealThreadCount()));
+        return threadPool;
+    }();
+    return instance;
+}
+
+void ResponseParseStage::setMaxConcurrency(int threads) {
+    pool()->setMaxThreadCount(qMax(1, threads));
+}
+
+int ResponseParseStage::maxConcurrency() {
+    return pool()->maxThreadCount();
+}
+
+void ResponseParseStage::waitForDone() {
+    pool()->waitForDone();
+}
+
+StreamParseJob::StreamParseJob(const QString& arrayKey)
+    : parser(arrayKey)
+{
+}
+
+void StreamParseJob::append(const QByteArray& chunk) {
+    if (chunk.isEmpty()) {
+        return;
+    }
+    
+    QMutexLocker locker(&m_mutex);
+    if (m_closed) {
+        return;
+    }
+    m_chunks.append(chunk);
+    schedule();
+}
+
+void StreamParseJob::close(const QByteArray& rest, QObject* context, Completion done) {
+    QMutexLocker locker(&m_mutex);
+    if (m_closed) {
+        return;
+    }
+    if (!rest.isEmpty()) {
+        m_chunks.append(rest);
+    }
+    m_closed = true;
+    m_context = context;
+    m_done = std::move(done);
+    schedule();
+}
+
+void StreamParseJob::closeWithError(const QString& message, QObject* context, Completion done) {
+    QMutexLocker locker(&m_mutex);
+    if (m_closed) {
+        return;
+    }
+    m_closeError = message;
+    m_chunks.clear();
+    m_closed = true;
+    m_context = context;
+    m_done = std::move(done);
+    schedule();
+}
+
+void StreamParseJob::schedule() {
+    // 呼叫端持有 m_mutex；已有工作者在處理時由它接手新的片段
+    if (m_running) {
+        return;
+    }
+    m_running = true;
+    
+    QSharedPointer<StreamParseJob> self = sharedFromThis();
+    ResponseParseStage::pool()->start([self]() {
+        self->drain();
+    });
+}
+
+void StreamParseJob::drain() {
+    forever {
+        QList<QByteArray> chunks;
+        bool closed = false;
+        {
+            QMutexLocker locker(&m_mutex);
+            if (m_chunks.isEmpty() && !m_closed) {
+                m_running = false;
+                return;
+            }
+            chunks.swap(m_chunks);
+            closed = m_closed;
+            error = m_closeError;
+        }
+        
+        for (const QByteArray& chunk : chunks) {
+            parser.feed(chunk);
+        }
+        if (!closed) {
+            continue;
+        }
+        
+        if (error.isEmpty() && !parser.finish()) {
+            error = QString("解析%1回應失敗: %2").arg(label, parser.errorString());
+        }
+        if (error.isEmpty() && JsonStreamParser::benchmarkEnabled()) {
+            JsonStreamParser::logBenchmark(parser.recordedInput(), parser.arrayKey(), label);
+        }
+        
+        // close 之後不會再有新片段，完成回呼只會排入一次
+        QPointer<QObject> context;
+        Completion done;
+        {
+            QMutexLocker locker(&m_mutex);
+            context = m_context;
+            done = std::move(m_done);
+            m_done = nullptr;
+        }
+        if (context && done) {
+            QMetaObject::invokeMethod(context, std::move(done), Qt::QueuedConnection);
+        }
+        return;
+    }
+}
+
+void ParseReorderBuffer::reset() {
+    ++m_generation;
+    m_nextSequence = 0;
+    m_nextToDeliver = 0;
+    m_completed.clear();
+}
+
+void ParseReorderBuffer::enqueue(StreamParseJob* job) {
+    job->generation = m_generation;
+    job->sequence = m_nextSequence++;
+}
+
+QList<QSharedPointer<StreamParseJob>> ParseReorderBuffer::complete(const QSharedPointer<StreamParseJob>& job) {
+    QList<QSharedPointer<StreamParseJob>> ready;
+    if (job->generation != m_generation) {
+        return ready;
+    }
+    
+    m_completed.insert(job->sequence, job);
+    for (auto it = m_completed.begin(); it != m_completed.end() && it.key() == m_nextToDeliver;) {
+        ready.append(it.value());
+        it = m_completed.erase(it);
+        ++m_nextToDeliver;
+    }
+    return ready;
+}
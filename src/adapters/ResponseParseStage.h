@@ -0,0 +1,89 @@
+#pragma once
+
+#include "JsonStreamParser.h"
+#include <QObject>
+#include <QPointer>
+#include <QMutex>
+#include <QMap>
+#include <QList>
+#include <QSharedPointer>
+#include <QThreadPool>
+#include <functional>
+
+// 背景解析階段 - 回應的資料片段交給共用的 QThreadPool 解析，GUI 執行緒只負責收資料。
+// 同一回應的片段依序處理，同一時間至多一個工作者；不同回應（跨分頁、跨適配器）平行解析。
+class ResponseParseStage {
+public:
+    static QThreadPool* pool();
+    
+    // 同時解析的回應數上限，預設為 CPU 核心數
+    static void setMaxConcurrency(int threads);
+    static int maxConcurrency();
+    
+    // 等待所有解析工作結束（適配器解構時使用）
+    static void waitForDone();
+};
+
+// 一個回應的解析工作，必須以 QSharedPointer 建立（工作者執行緒持有參考直到完成）。
+// parser 的回呼在工作者執行緒執行，只能寫入工作本身的欄位；
+// 需要 GUI 執行緒的動作（例如送出下一頁請求）必須以 QMetaObject::invokeMethod 排入。
+class StreamParseJob : public QEnableSharedFromThis<StreamParseJob> {
+public:
+    using Completion = std::function<void()>;
+    
+    explicit StreamParseJob(const QString& arrayKey);
+    virtual ~StreamParseJob() = default;
+    
+    JsonStreamParser parser;
+    QString label;           // 用於記錄與效能比較
+    QString error;           // 網路或解析錯誤；完成回呼之後才可讀取
+    int sequence = -1;       // 在所屬取得中的順序，由 ParseReorderBuffer 指定
+    int generation = -1;
+    
+    // 回應快取：cacheKey 為空表示不快取；fromCache 表示沿用 304 之前的解析結果，
+    // servedStale 表示已先以快取內容送出（stale-while-revalidate）
+    QString cacheKey;
+    bool fromCache = false;
+    bool servedStale = false;
+    
+    // 以下在 GUI 執行緒呼叫
+    void append(const QByteArray& chunk);
+    
+    // 資料已全部送達；解析完成後在 context 所在執行緒呼叫 done
+    void close(const QByteArray& rest, QObject* context, Completion done);
+    
+    // 以錯誤結束，捨棄尚未解析的片段；完成回呼同樣經由工作者排入
+    void closeWithError(const QString& message, QObject* context, Completion done);
+    
+private:
+    void schedule();
+    void drain();
+    
+    QMutex m_mutex;
+    QList<QByteArray> m_chunks;
+    bool m_running = false;
+    bool m_closed = false;
+    QString m_closeError;
+    QPointer<QObject> m_context;
+    Completion m_done;
+};
+
+// 同一次取得的分頁可能不依序解析完成；依送出請求的順序交付。
+// reset() 之後，舊世代的工作完成時會被忽略。
+class ParseReorderBuffer {
+public:
+    void reset();
+    int generation() const { return m_generation; }
+    
+    // 送出請求時呼叫，指定工作的順序
+    void enqueue(StreamParseJob* job);
+    
+    // 工作完成時呼叫；回傳可依序交付的工作（可能為空）
+    QList<QSharedPointer<StreamParseJob>> complete(const QSharedPointer<StreamParseJob>& job);
+    
+private:
+    int m_generation = 0;
+    int m_nextSequence = 0;
+    int m_nextToDeliver = 0;
+    QMap<int, QSharedPointer<StreamParseJob>> m_completed;
+};
@@ -1,4 +1,33 @@
 #include "CalendarEvent.h"
+#include <algorithm>
+
+bool CalendarEvent::operator==(const CalendarEvent& other) const {
+    return id == other.id &&
+           platform == other.platform &&
+           ownerId == other.ownerId &&
+           title == other.title &&
+           description == other.description &&
+           startTime == other.startTime &&
+           endTime == other.endTime &&
+           location == other.location &&
+           isAllDay == other.isAllDay &&
+           attendees == other.attendees &&
+           recurrenceRule == other.recurrenceRule &&
+           seriesMasterId == other.seriesMasterId &&
+           originalStartTime == other.originalStartTime &&
+           isCancelled == other.isCancelled &&
+           iCalUid == other.iCalUid &&
+           color == other.color &&
+           mergedSources == other.mergedSources;
+}
+
+bool CalendarEvent::hasSource(Platform source) const {
+    if (platform == source) {
+        return true;
+    }
+    return std::any_of(mergedSources.cbegin(), mergedSources.cend(),
+                       [source](const EventSource& merged) { return merged.platform == source; });
+}
 
 QString CalendarEvent::toString() const {
     return QString("Event: %1 (%2 - %3) at %4 [%5]")
@@ -11,6 +11,17 @@ enum class Platform {
     Outlook
 };
 
+// 事件在某個平台上的來源
+struct EventSource {
+    Platform platform;
+    QString ownerId;
+    QString id;
+    
+    bool operator==(const EventSource& other) const {
+        return platform == other.platform && ownerId == other.ownerId && id == other.id;
+    }
+};
+
 // 統一的事件資料結構
 class CalendarEvent {
 public:
@@ -26,9 +37,24 @@ public:
     QString ownerId;
     bool isAllDay = false;
     QStringList attendees;
-    QString recurrenceRule;
+    QString recurrenceRule;     // RRULE/EXDATE/RDATE 行，以換行分隔
+    QString seriesMasterId;     // 重複系列中的實例或例外所屬的主事件 id
+    QDateTime originalStartTime; // 例外實例原本的開始時間
+    bool isCancelled = false;   // 已取消的重複實例
+    QString iCalUid;            // iCalendar UID，同一會議在不同平台上相同
     QColor color;
     
+    // 合併重複會議後其他平台上的來源（只出現在合併後的顯示結果中）
+    QList<EventSource> mergedSources;
+    
+    bool hasSource(Platform source) const;
+    
+    // 是否為需要在本地展開的重複系列主事件
+    bool isSeriesMaster() const { return !recurrenceRule.isEmpty() && seriesMasterId.isEmpty(); }
+    
+    bool operator==(const CalendarEvent& other) const;
+    bool operator!=(const CalendarEvent& other) const { return !(*this == other); }
+    
     // 轉換為字串以便除錯
     QString toString() const;
 };
@@ -1,9 +1,17 @@
 #include "CalendarManager.h"
+#include "storage/DatabaseManager.h"
 #include <QDebug>
+#include <QReadLocker>
+#include <QTimeZone>
+#include <QWriteLocker>
+#include <algorithm>
 
 CalendarManager::CalendarManager(QObject* parent)
     : QObject(parent)
 {
+    m_freeBusy.setProvider([this](qint64 startMs, qint64 endMs) {
+        return busySources(startMs, endMs);
+    });
 }
 
 CalendarManager::~CalendarManager() = default;
@@ -18,24 +26,85 @@ void CalendarManager::addAdapter(CalendarAdapter* adapter) {
     // 連接適配器信號
     connect(adapter, &CalendarAdapter::eventsReceived,
             this, &CalendarManager::onAdapterEventsReceived);
+    connect(adapter, &CalendarAdapter::eventChangesReceived,
+            this, &CalendarManager::onAdapterEventChanges);
+    connect(adapter, &CalendarAdapter::syncStateUpdated,
+            this, &CalendarManager::onAdapterSyncStateUpdated);
     connect(adapter, &CalendarAdapter::tasksReceived,
             this, &CalendarManager::onAdapterTasksReceived);
+    connect(adapter, &CalendarAdapter::fetchCompleted,
+            this, &CalendarManager::onAdapterFetchCompleted);
     connect(adapter, &CalendarAdapter::errorOccurred,
             this, &CalendarManager::onAdapterError);
     
     qDebug() << "已新增平台適配器";
 }
 
+void CalendarManager::setDatabase(DatabaseManager* database) {
+    m_database = database;
+}
+
 void CalendarManager::fetchAllEvents(const QDateTime& start, const QDateTime& end) {
     qDebug() << "從所有平台獲取事件...";
     
-    m_allEvents.clear();
+    {
+        QWriteLocker locker(&m_storeLock);
+        m_store.clear();
+    }
+    m_expander.clear();
+    m_freeBusy.clear();
+    setEventWindow(start, end);
+    emit eventsReset();
+    recheckConflicts();
     
     for (auto* adapter : m_adapters) {
         adapter->fetchEvents(start, end);
     }
 }
 
+QString CalendarManager::syncScope(const QDateTime& start, const QDateTime& end) {
+    return start.toUTC().toString(Qt::ISODate) + "/" + end.toUTC().toString(Qt::ISODate);
+}
+
+void CalendarManager::syncAllEvents(const QDateTime& start, const QDateTime& end) {
+    qDebug() << "增量同步所有平台事件...";
+    
+    const QString scope = syncScope(start, end);
+    
+    // 範圍改變時以本地資料庫的快取作為增量同步的基準
+    if (scope != m_syncScope) {
+        m_syncScope = scope;
+        const QList<CalendarEvent> cached = m_database ? m_database->loadEvents(start, end)
+                                                       : QList<CalendarEvent>();
+        {
+            QWriteLocker locker(&m_storeLock);
+            m_store.clear();
+            for (const auto& event : cached) {
+                m_store.upsert(event);
+            }
+        }
+        m_expander.clear();
+        m_freeBusy.clear();
+        setEventWindow(start, end);
+        emit eventsReset();
+        recheckConflicts();
+    }
+    
+    // 每個行事曆各自保存同步狀態，沒有狀態的行事曆由適配器完整同步
+    for (auto* adapter : m_adapters) {
+        QHash<QString, QString> syncStates;
+        if (m_database) {
+            for (const QString& calendarId : adapter->syncCalendarIds()) {
+                const QString syncState = m_database->loadSyncState(adapter->platform(), calendarId, scope);
+                if (!syncState.isEmpty()) {
+                    syncStates.insert(calendarId, syncState);
+                }
+            }
+        }
+        adapter->syncEvents(start, end, syncStates);
+    }
+}
+
 void CalendarManager::fetchAllTasks() {
     qDebug() << "從所有平台獲取任務...";
     
@@ -47,24 +116,484 @@ void CalendarManager::fetchAllTasks() {
 }
 
 QList<CalendarEvent> CalendarManager::searchEvents(const QString& query) const {
+    // n-gram 索引取得候選，結果依開始時間排序
+    return EventMerger::mergeDuplicates(m_store.eventsForSlots(m_store.searchText(query)));
+}
+
+CalendarManager::SearchResult CalendarManager::searchConcurrent(const QString& query,
+                                                              const SearchResult* previous,
+                                                              const std::function<bool()>& isCanceled) const {
+    QReadLocker locker(&m_storeLock);
+    
+    SearchResult result;
+    result.query = query;
+    result.revision = m_store.revision();
+    
+    // 查詢字串延長時，符合新查詢的事件必定在前次結果中
+    const bool narrow = previous && !previous->query.isEmpty() &&
+                        previous->revision == result.revision &&
+                        TrigramIndex::fold(query).contains(TrigramIndex::fold(previous->query));
+    result.slotIds = narrow ? m_store.filterText(previous->slotIds, query, isCanceled)
+                            : m_store.searchText(query, isCanceled);
+    
+    if (isCanceled && isCanceled()) {
+        return result;
+    }
+    result.events = EventMerger::mergeDuplicates(m_store.eventsForSlots(result.slotIds));
+    return result;
+}
+
+QList<CalendarEvent> CalendarManager::searchEventsRanked(const QString& query) const {
+    // 全文檢索無法處理的查詢（例如少於 3 個字的中文詞）改用 n-gram 索引
+    if (!m_database || !m_database->canSearchFullText(query)) {
+        return searchEvents(query);
+    }
+    
+    // 全文檢索結果對應回記憶體中的事件，保留相關度順序
     QList<CalendarEvent> results;
+    const QStringList ids = searchEventIds(query, m_store.size());
+    for (const QString& id : ids) {
+        if (const auto event = m_store.findById(id)) {
+            results.append(*event);
+        }
+    }
+    
+    return EventMerger::mergeDuplicates(results);
+}
+
+QStringList CalendarManager::searchEventIds(const QString& query, int limit) const {
+    if (!m_database) {
+        return {};
+    }
+    return m_database->searchEventIds(query, limit);
+}
+
+QList<CalendarEvent> CalendarManager::eventsOverlapping(const QDateTime& start, const QDateTime& end) const {
+    return m_store.eventsForSlots(
+        m_store.timeIndex().overlapping(start.toMSecsSinceEpoch(), end.toMSecsSinceEpoch()));
+}
+
+QList<CalendarEvent> CalendarManager::eventsAt(const QDateTime& instant) const {
+    return m_store.eventsForSlots(m_store.timeIndex().at(instant.toMSecsSinceEpoch()));
+}
+
+QList<CalendarEvent> CalendarManager::nextEvents(const QDateTime& after, int count) const {
+    return m_store.eventsForSlots(m_store.timeIndex().nextAfter(after.toMSecsSinceEpoch(), count));
+}
+
+QVector<FreeBusyEngine::BusyInterval> CalendarManager::busyIntervals(const QDateTime& start,
+                                                                     const QDateTime& end,
+                                                                     const QString& ownerId) const {
+    return m_freeBusy.busy(start.toMSecsSinceEpoch(), end.toMSecsSinceEpoch(), ownerId);
+}
+
+QHash<QString, QVector<FreeBusyEngine::BusyInterval>> CalendarManager::busyIntervalsByOwner(
+    const QDateTime& start, const QDateTime& end) const {
+    return m_freeBusy.busyByOwner(start.toMSecsSinceEpoch(), end.toMSecsSinceEpoch());
+}
+
+QBitArray CalendarManager::busySlots(const QDateTime& start, const QDateTime& end, int slotMinutes,
+                                     const QString& ownerId) const {
+    return m_freeBusy.busySlots(start.toMSecsSinceEpoch(), end.toMSecsSinceEpoch(),
+                                qint64(slotMinutes) * 60 * 1000, ownerId);
+}
+
+QVector<FreeBusyEngine::SourceInterval> CalendarManager::busySources(qint64 startMs, qint64 endMs) const {
+    QVector<FreeBusyEngine::SourceInterval> result;
+    
+    // 直接讀取緊湊儲存的時間欄位，不組出事件
+    for (int slot : m_store.timeIndex().overlapping(startMs, endMs)) {
+        if (m_store.isAllDayAt(slot) || m_store.hasSeriesMasterAt(slot)) {
+            continue;
+        }
+        const qint64 eventStart = m_store.startMsAt(slot);
+        const qint64 eventEnd = m_store.endMsAt(slot);
+        if (eventEnd > eventStart) {
+            result.append({eventStart, eventEnd, m_store.ownerIdAt(slot)});
+        }
+    }
+    
+    // 重複系列只展開查詢的日期範圍
+    const QDateTime start = QDateTime::fromMSecsSinceEpoch(startMs, QTimeZone::utc());
+    const QDateTime end = QDateTime::fromMSecsSinceEpoch(endMs, QTimeZone::utc());
+    for (int slot : m_store.seriesMasterSlots()) {
+        const CalendarEvent master = m_store.at(slot);
+        if (master.isAllDay) {
+            continue;
+        }
+        for (const auto& occurrence : m_expander.expand(master, start, end, m_store.exceptionsOf(master))) {
+            result.append({occurrence.startTime.toMSecsSinceEpoch(), occurrence.endTime.toMSecsSinceEpoch(),
+                           occurrence.ownerId});
+        }
+    }
+    
+    return result;
+}
+
+void CalendarManager::invalidateEventRange(const CalendarEvent& event) {
+    // 系列主事件影響的範圍沒有上限，全部重新計算
+    if (event.isSeriesMaster()) {
+        invalidateAllRanges();
+        return;
+    }
+    
+    invalidateRange(event.startTime.toMSecsSinceEpoch(), event.endTime.toMSecsSinceEpoch());
+    if (event.originalStartTime.isValid()) {
+        // 例外實例會取代原本時間的展開結果
+        const qint64 original = event.originalStartTime.toMSecsSinceEpoch();
+        invalidateRange(original, original + event.startTime.msecsTo(event.endTime));
+    }
+}
+
+void CalendarManager::invalidateRange(qint64 startMs, qint64 endMs) {
+    m_freeBusy.invalidate(startMs, endMs);
+    if (!m_conflictRecheckAll) {
+        m_conflictDirty.append({startMs, std::max(startMs + 1, endMs)});
+    }
+}
+
+void CalendarManager::invalidateAllRanges() {
+    m_freeBusy.clear();
+    m_conflictDirty.clear();
+    m_conflictRecheckAll = true;
+}
+
+void CalendarManager::setEventWindow(const QDateTime& start, const QDateTime& end) {
+    m_windowStartMs = start.toMSecsSinceEpoch();
+    m_windowEndMs = end.toMSecsSinceEpoch();
+    m_conflictDirty.clear();
+    m_conflictRecheckAll = true;
+}
+
+void CalendarManager::setConflictOptions(const ConflictDetector::Options& options) {
+    if (options == m_conflicts.options()) {
+        return;
+    }
+    m_conflicts.setOptions(options);
+    m_conflictRecheckAll = true;
+    recheckConflicts();
+}
+
+QVector<ConflictDetector::Entry> CalendarManager::conflictEntries(qint64 startMs, qint64 endMs) const {
+    const bool includeAllDay = m_conflicts.options().allDayPolicy == ConflictDetector::AllDayPolicy::Include;
+    QVector<ConflictDetector::Entry> entries;
+    
+    for (int slot : m_store.timeIndex().overlapping(startMs, endMs)) {
+        const bool allDay = m_store.isAllDayAt(slot);
+        if ((allDay && !includeAllDay) || m_store.hasSeriesMasterAt(slot)) {
+            continue;
+        }
+        entries.append({{m_store.platformAt(slot), m_store.ownerIdAt(slot), m_store.idAt(slot)},
+                        m_store.startMsAt(slot), m_store.endMsAt(slot), allDay, m_store.iCalUidAt(slot)});
+    }
+    
+    const QDateTime start = QDateTime::fromMSecsSinceEpoch(startMs, QTimeZone::utc());
+    const QDateTime end = QDateTime::fromMSecsSinceEpoch(endMs, QTimeZone::utc());
+    for (int slot : m_store.seriesMasterSlots()) {
+        const CalendarEvent master = m_store.at(slot);
+        if (master.isAllDay && !includeAllDay) {
+            continue;
+        }
+        for (const auto& occurrence : m_expander.expand(master, start, end, m_store.exceptionsOf(master))) {
+            entries.append({EventKey::of(occurrence), occurrence.startTime.toMSecsSinceEpoch(),
+                            occurrence.endTime.toMSecsSinceEpoch(), occurrence.isAllDay, occurrence.iCalUid});
+        }
+    }
+    return entries;
+}
+
+void CalendarManager::recheckConflicts() {
+    QVector<FreeBusyEngine::BusyInterval> ranges;
+    bool changed = false;
+    
+    if (m_conflictRecheckAll) {
+        // 取得視窗與所有已儲存事件的聯集
+        qint64 startMs = m_windowStartMs;
+        qint64 endMs = m_windowEndMs;
+        for (int slot : m_store.timeIndex().slotsInOrder()) {
+            startMs = std::min(startMs, m_store.startMsAt(slot));
+            endMs = std::max(endMs, m_store.endMsAt(slot));
+        }
+        changed = !m_conflicts.conflicts().isEmpty();
+        m_conflicts.clear();
+        if (startMs < endMs) {
+            ranges.append({startMs, endMs});
+        }
+    } else {
+        ranges = FreeBusyEngine::merge(m_conflictDirty);
+    }
+    m_conflictDirty.clear();
+    m_conflictRecheckAll = false;
+    
+    for (const auto& range : ranges) {
+        // 擴大範圍直到不會切開任何事件或既有的衝突群組
+        qint64 startMs = range.startMs;
+        qint64 endMs = range.endMs;
+        QVector<ConflictDetector::Entry> entries;
+        for (;;) {
+            const auto span = m_conflicts.conflictSpan(startMs, endMs);
+            qint64 nextStart = span.first;
+            qint64 nextEnd = span.second;
+            entries = conflictEntries(nextStart, nextEnd);
+            for (const auto& entry : entries) {
+                nextStart = std::min(nextStart, entry.startMs);
+                nextEnd = std::max(nextEnd, entry.endMs);
+            }
+            if (nextStart == startMs && nextEnd == endMs) {
+                break;
+            }
+            startMs = nextStart;
+            endMs = nextEnd;
+        }
+        changed |= m_conflicts.replaceRange(startMs, endMs, entries);
+    }
+    
+    if (changed) {
+        qDebug() << "偵測到" << m_conflicts.conflicts().size() << "組時間衝突";
+        emit conflictsDetected(m_conflicts.conflicts());
+    }
+}
+
+QList<MeetingSlotFinder::Candidate> CalendarManager::findMeetingSlots(
+    const MeetingSlotFinder::Request& request) const {
+    const auto busy = attendeeBusy(request.attendees, request.start.toMSecsSinceEpoch(),
+                                   request.end.toMSecsSinceEpoch());
+    return MeetingSlotFinder::find(request, busy);
+}
+
+QVector<QVector<FreeBusyEngine::BusyInterval>> CalendarManager::attendeeBusy(const QStringList& attendees,
+                                                                           qint64 startMs,
+                                                                           qint64 endMs) const {
+    QVector<QVector<FreeBusyEngine::BusyInterval>> result(attendees.size());
+    
+    // 大小寫不同或重複列出的參與者會對應到同一個 email / 字串池 id，每位都要記入忙碌時段
+    QMultiHash<QString, int> indexByEmail;
+    for (int i = 0; i < attendees.size(); ++i) {
+        indexByEmail.insert(attendees[i].toLower(), i);
+    }
+    
+    // 先把 email 對應到字串池 id，之後逐事件只比對整數
+    QMultiHash<quint32, int> indexByRef;
+    for (int i = 0; i < attendees.size(); ++i) {
+        for (quint32 ref : m_store.foldedRefs(attendees[i])) {
+            if (!indexByRef.contains(ref, i)) {
+                indexByRef.insert(ref, i);
+            }
+        }
+    }
+    
+    auto addBusy = [&result](int index, qint64 start, qint64 end) {
+        if (end > start) {
+            result[index].append({start, end});
+        }
+    };
+    auto addBusyByRef = [&indexByRef, &addBusy](quint32 ref, qint64 start, qint64 end) {
+        for (auto it = indexByRef.constFind(ref); it != indexByRef.constEnd() && it.key() == ref; ++it) {
+            addBusy(it.value(), start, end);
+        }
+    };
+    
+    for (int slot : m_store.timeIndex().overlapping(startMs, endMs)) {
+        if (m_store.isAllDayAt(slot) || m_store.hasSeriesMasterAt(slot)) {
+            continue;
+        }
+        const qint64 eventStart = m_store.startMsAt(slot);
+        const qint64 eventEnd = m_store.endMsAt(slot);
+        addBusyByRef(m_store.ownerRefAt(slot), eventStart, eventEnd);
+        for (quint32 ref : m_store.attendeeRefsAt(slot)) {
+            addBusyByRef(ref, eventStart, eventEnd);
+        }
+    }
+    
+    // 重複系列展開後以 email 比對
+    const QDateTime start = QDateTime::fromMSecsSinceEpoch(startMs, QTimeZone::utc());
+    const QDateTime end = QDateTime::fromMSecsSinceEpoch(endMs, QTimeZone::utc());
+    for (int slot : m_store.seriesMasterSlots()) {
+        const CalendarEvent master = m_store.at(slot);
+        if (master.isAllDay) {
+            continue;
+        }
+        for (const auto& occurrence : m_expander.expand(master, start, end, m_store.exceptionsOf(master))) {
+            const qint64 occurrenceStart = occurrence.startTime.toMSecsSinceEpoch();
+            const qint64 occurrenceEnd = occurrence.endTime.toMSecsSinceEpoch();
+            QStringList emails = occurrence.attendees;
+            emails.append(occurrence.ownerId);
+            for (const QString& email : emails) {
+                const QString folded = email.toLower();
+                for (auto it = indexByEmail.constFind(folded); it != indexByEmail.constEnd() && it.key() == folded; ++it) {
+                    addBusy(it.value(), occurrenceStart, occurrenceEnd);
+                }
+            }
+        }
+    }
     
-    for (const auto& event : m_allEvents) {
-        if (event.title.contains(query, Qt::CaseInsensitive) ||
-            event.description.contains(query, Qt::CaseInsensitive) ||
-            event.location.contains(query, Qt::CaseInsensitive)) {
-            results.append(event);
+    for (auto& intervals : result) {
+        intervals = FreeBusyEngine::merge(std::move(intervals));
+    }
+    return result;
+}
+
+QList<CalendarEvent> CalendarManager::expandedEvents(const QDateTime& start, const QDateTime& end) const {
+    QList<CalendarEvent> result;
+    
+    // 主事件已在本地時，其例外實例改由展開結果提供，避免重複
+    for (const auto& event : eventsOverlapping(start, end)) {
+        if (!m_store.hasSeriesMaster(event)) {
+            result.append(event);
         }
     }
     
-    return results;
+    // 只展開查詢範圍；展開結果依系列快取，規則或例外變更時自動失效
+    for (int slot : m_store.seriesMasterSlots()) {
+        const CalendarEvent master = m_store.at(slot);
+        result += m_expander.expand(master, start, end, m_store.exceptionsOf(master));
+    }
+    
+    std::stable_sort(result.begin(), result.end(), [](const CalendarEvent& a, const CalendarEvent& b) {
+        return a.startTime < b.startTime;
+    });
+    return result;
+}
+
+QList<CalendarEvent> CalendarManager::expandedEventsFor(const QList<CalendarEvent>& events,
+                                                        const QDateTime& start, const QDateTime& end,
+                                                        QList<EventKey>* series) const {
+    QList<CalendarEvent> result;
+    QSet<EventKey> expandedSeries;
+    const qint64 startMs = start.toMSecsSinceEpoch();
+    const qint64 endMs = end.toMSecsSinceEpoch();
+    
+    for (const auto& event : events) {
+        // 主事件或主事件在本地的例外：重新展開整個系列（展開結果依系列快取）
+        if (event.isSeriesMaster() || m_store.hasSeriesMaster(event)) {
+            const EventKey masterKey = event.isSeriesMaster()
+                ? EventKey::of(event) : EventKey{event.platform, event.ownerId, event.seriesMasterId};
+            if (expandedSeries.contains(masterKey)) {
+                continue;
+            }
+            expandedSeries.insert(masterKey);
+            series->append(masterKey);
+            
+            const int masterSlot = m_store.slotOf(masterKey);
+            if (masterSlot >= 0 && m_store.isSeriesMasterAt(masterSlot)) {
+                const CalendarEvent master = m_store.at(masterSlot);
+                result += m_expander.expand(master, start, end, m_store.exceptionsOf(master));
+                continue;
+            }
+            
+            // 主事件已刪除：留下的例外改為單獨顯示
+            for (const auto& exception : m_store.exceptionsOf(event)) {
+                const int slot = m_store.slotOf(EventKey::of(exception));
+                if (m_store.timeIndex().contains(slot) && m_store.startMsAt(slot) < endMs &&
+                    qMax(m_store.endMsAt(slot), m_store.startMsAt(slot) + 1) > startMs) {
+                    result.append(exception);
+                }
+            }
+            continue;
+        }
+        
+        // 一般事件以 store 中目前的內容為準；已取消或不在範圍內時不顯示
+        const int slot = m_store.slotOf(EventKey::of(event));
+        if (slot >= 0 && m_store.timeIndex().contains(slot) && m_store.startMsAt(slot) < endMs &&
+            qMax(m_store.endMsAt(slot), m_store.startMsAt(slot) + 1) > startMs) {
+            result.append(m_store.at(slot));
+        }
+    }
+    return result;
 }
 
 void CalendarManager::onAdapterEventsReceived(const QList<CalendarEvent>& events) {
     qDebug() << "收到" << events.size() << "個事件";
     
-    m_allEvents.append(events);
-    emit eventsUpdated(m_allEvents);
+    applyEvents(events);
+}
+
+void CalendarManager::applyEvents(const QList<CalendarEvent>& events) {
+    QList<CalendarEvent> added;
+    QList<CalendarEvent> changed;
+    
+    // 以 (platform, ownerId, id) 做 upsert，重複或遲到的回應不會產生重複事件
+    {
+        QWriteLocker locker(&m_storeLock);
+        for (const auto& event : events) {
+            // 記下舊的時間範圍，更新後讓新舊範圍的忙碌時段與衝突都重新計算
+            const int oldSlot = m_store.slotOf(EventKey::of(event));
+            const bool oldMaster = oldSlot >= 0 && m_store.isSeriesMasterAt(oldSlot);
+            const qint64 oldStart = oldSlot >= 0 ? m_store.startMsAt(oldSlot) : 0;
+            const qint64 oldEnd = oldSlot >= 0 ? m_store.endMsAt(oldSlot) : 0;
+            
+            switch (m_store.upsert(event)) {
+                case EventStore::UpsertResult::Inserted:
+                    added.append(event);
+                    invalidateEventRange(event);
+                    break;
+                case EventStore::UpsertResult::Updated:
+                    changed.append(event);
+                    if (oldMaster) {
+                        invalidateAllRanges();
+                    } else {
+                        invalidateRange(oldStart, oldEnd);
+                    }
+                    invalidateEventRange(event);
+                    break;
+                case EventStore::UpsertResult::Unchanged:
+                    break;
+            }
+        }
+    }
+    
+    if (!added.isEmpty()) {
+        emit eventsAdded(added);
+    }
+    if (!changed.isEmpty()) {
+        emit eventsChanged(changed);
+    }
+    recheckConflicts();
+}
+
+void CalendarManager::onAdapterEventChanges(const QList<CalendarEvent>& changed,
+                                            const QStringList& removedIds) {
+    qDebug() << "收到" << changed.size() << "個變更事件，" << removedIds.size() << "個刪除";
+    
+    applyEvents(changed);
+    
+    // 刪除通知只有 id，依來源適配器的平台比對
+    auto* adapter = qobject_cast<CalendarAdapter*>(sender());
+    if (adapter && !removedIds.isEmpty()) {
+        // 只回報確實從 store 移除的事件；不在 store 中的 id（例如範圍外的事件）略過
+        QList<CalendarEvent> actuallyRemoved;
+        {
+            QWriteLocker locker(&m_storeLock);
+            for (const QString& id : removedIds) {
+                for (const auto& removed : m_store.removeById(adapter->platform(), id)) {
+                    invalidateEventRange(removed);
+                    actuallyRemoved.append(removed);
+                }
+            }
+        }
+        if (!actuallyRemoved.isEmpty()) {
+            emit eventsRemoved(actuallyRemoved);
+            recheckConflicts();
+        }
+    }
+}
+
+void CalendarManager::onAdapterSyncStateUpdated(const QString& calendarId, const QString& syncState) {
+    auto* adapter = qobject_cast<CalendarAdapter*>(sender());
+    if (!adapter || !m_database) {
+        return;
+    }
+    
+    m_database->saveSyncState(adapter->platform(), calendarId, m_syncScope, syncState);
+}
+
+void CalendarManager::onAdapterFetchCompleted(int eventCount) {
+    auto* adapter = qobject_cast<CalendarAdapter*>(sender());
+    if (!adapter) {
+        return;
+    }
+    qDebug() << "平台事件已全部取得，共" << eventCount << "個";
+    emit fetchCompleted(adapter->platform(), eventCount);
 }
 
 void CalendarManager::onAdapterTasksReceived(const QList<Task>& tasks) {
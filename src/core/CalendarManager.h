@@ -2,41 +2,156 @@
 
 #include <QObject>
 #include <QList>
+#include <QReadWriteLock>
+#include <functional>
 #include "CalendarEvent.h"
+#include "EventStore.h"
+#include "RecurrenceExpander.h"
+#include "FreeBusyEngine.h"
+#include "MeetingSlotFinder.h"
+#include "ConflictDetector.h"
+#include "EventMerger.h"
 #include "adapters/CalendarAdapter.h"
 
+class DatabaseManager;
+
 // 行事曆管理器 - 統一管理所有平台的行事曆
 class CalendarManager : public QObject {
     Q_OBJECT
     
 public:
+    // 背景搜尋的結果；revision 為搜尋當下的儲存版本
+    struct SearchResult {
+        QString query;
+        quint64 revision = 0;
+        QList<int> slotIds;
+        QList<CalendarEvent> events;
+    };
+    
     explicit CalendarManager(QObject* parent = nullptr);
     ~CalendarManager() override;
     
     // 新增平台適配器
     void addAdapter(CalendarAdapter* adapter);
     
+    // 設定本地資料庫（提供全文檢索）
+    void setDatabase(DatabaseManager* database);
+    
     // 獲取所有事件
     void fetchAllEvents(const QDateTime& start, const QDateTime& end);
     
+    // 增量同步：沿用保存的同步狀態，只取得變更與刪除
+    void syncAllEvents(const QDateTime& start, const QDateTime& end);
+    
     // 獲取所有任務
     void fetchAllTasks();
     
-    // 搜尋事件
+    // 子字串搜尋（不分大小寫，支援中文），以記憶體中的 n-gram 索引即時回應
     QList<CalendarEvent> searchEvents(const QString& query) const;
     
+    // 可在背景執行緒呼叫的子字串搜尋。previous 的查詢被 query 包含且儲存未變更時，
+    // 只在前次結果中比對；isCanceled 回傳 true 時提早結束
+    SearchResult searchConcurrent(const QString& query, const SearchResult* previous = nullptr,
+                                  const std::function<bool()>& isCanceled = {}) const;
+    
+    // 全文檢索，依相關度排序；沒有全文檢索或查詢無法以全文檢索處理時退回子字串搜尋
+    QList<CalendarEvent> searchEventsRanked(const QString& query) const;
+    
+    // 全文檢索，回傳依相關度排序的事件 id
+    QStringList searchEventIds(const QString& query, int limit = 200) const;
+    
+    // 目前所有事件（已去除重複），依開始時間排序
+    QList<CalendarEvent> events() const { return m_store.events(); }
+    int eventCount() const { return m_store.size(); }
+    
+    // 依 id 的 O(1) 查找
+    std::optional<CalendarEvent> findEvent(const QString& id) const { return m_store.findById(id); }
+    
+    // 事件儲存的記憶體用量（緊湊儲存與完整物件的比較）
+    EventStore::MemoryStats memoryStats() const { return m_store.memoryStats(); }
+    
+    // 時間索引查詢（對數時間），結果依開始時間排序
+    QList<CalendarEvent> eventsOverlapping(const QDateTime& start, const QDateTime& end) const;
+    QList<CalendarEvent> eventsAt(const QDateTime& instant) const;
+    QList<CalendarEvent> nextEvents(const QDateTime& after, int count) const;
+    
+    // 所有行事曆合併後的忙碌區間（不含全天事件），依日期快取並隨事件變更失效；
+    // ownerId 非空時只計算該擁有者
+    QVector<FreeBusyEngine::BusyInterval> busyIntervals(const QDateTime& start, const QDateTime& end,
+                                                        const QString& ownerId = QString()) const;
+    QHash<QString, QVector<FreeBusyEngine::BusyInterval>> busyIntervalsByOwner(const QDateTime& start,
+                                                                               const QDateTime& end) const;
+    
+    // 以固定分鐘數切割時段，忙碌的時段為 1
+    QBitArray busySlots(const QDateTime& start, const QDateTime& end, int slotMinutes = 15,
+                        const QString& ownerId = QString()) const;
+    
+    // 找出所有參與者都有空的會議時段。參與者的忙碌時間來自其擁有的行事曆，
+    // 以及列為參與者的已讀取事件
+    QList<MeetingSlotFinder::Candidate> findMeetingSlots(const MeetingSlotFinder::Request& request) const;
+    
+    // 重疊事件偵測（含重複系列的實例）；事件變更時只重新檢查受影響的時間範圍
+    void setConflictOptions(const ConflictDetector::Options& options);
+    const ConflictDetector::Options& conflictOptions() const { return m_conflicts.options(); }
+    const QList<ConflictDetector::Conflict>& conflicts() const { return m_conflicts.conflicts(); }
+    QSet<EventKey> conflictingEvents() const { return m_conflicts.conflictingEvents(); }
+    
+    // 範圍內要顯示的事件：一般事件加上重複系列在範圍內展開的實例，依開始時間排序。
+    // 跨平台的重複會議不在此合併，由 EventListModel 依列合併
+    QList<CalendarEvent> expandedEvents(const QDateTime& start, const QDateTime& end) const;
+    
+    // 增量更新用：只重新計算 events 影響到的顯示事件。主事件與其例外只重新展開該系列，
+    // 系列主事件的鍵加入 series，呼叫端應先移除該系列舊的實例；已刪除或不在範圍內的事件不回傳
+    QList<CalendarEvent> expandedEventsFor(const QList<CalendarEvent>& events, const QDateTime& start,
+                                           const QDateTime& end, QList<EventKey>* series) const;
+                                           
 signals:
-    void eventsUpdated(const QList<CalendarEvent>& events);
+    // 細粒度變更通知，只帶有受影響的事件；完整清單請以 events() 取得
+    void eventsAdded(const QList<CalendarEvent>& events);
+    void eventsChanged(const QList<CalendarEvent>& events);
+    void eventsRemoved(const QList<CalendarEvent>& events);
+    void eventsReset();
+    
+    // 某個平台的所有分頁都已取得（事件已先以 eventsAdded / eventsChanged 逐頁送出）
+    void fetchCompleted(Platform platform, int eventCount);
     void tasksUpdated(const QList<Task>& tasks);
     void errorOccurred(const QString& error);
     
+    // 衝突有變更時發出，帶有目前所有衝突群組
+    void conflictsDetected(const QList<ConflictDetector::Conflict>& conflicts);
+    
 private slots:
     void onAdapterEventsReceived(const QList<CalendarEvent>& events);
+    void onAdapterEventChanges(const QList<CalendarEvent>& changed, const QStringList& removedIds);
+    void onAdapterSyncStateUpdated(const QString& calendarId, const QString& syncState);
+    void onAdapterFetchCompleted(int eventCount);
     void onAdapterTasksReceived(const QList<Task>& tasks);
     void onAdapterError(const QString& error);
     
 private:
+    static QString syncScope(const QDateTime& start, const QDateTime& end);
+    void applyEvents(const QList<CalendarEvent>& events);
+    QVector<FreeBusyEngine::SourceInterval> busySources(qint64 startMs, qint64 endMs) const;
+    void invalidateEventRange(const CalendarEvent& event);
+    void invalidateRange(qint64 startMs, qint64 endMs);
+    void invalidateAllRanges();
+    void setEventWindow(const QDateTime& start, const QDateTime& end);
+    QVector<ConflictDetector::Entry> conflictEntries(qint64 startMs, qint64 endMs) const;
+    void recheckConflicts();
+    QVector<QVector<FreeBusyEngine::BusyInterval>> attendeeBusy(const QStringList& attendees,
+                                                              qint64 startMs, qint64 endMs) const;
+    
     QList<CalendarAdapter*> m_adapters;
-    QList<CalendarEvent> m_allEvents;
+    DatabaseManager* m_database = nullptr;
+    EventStore m_store;
+    mutable QReadWriteLock m_storeLock;  // 事件只在主執行緒寫入，背景搜尋以讀鎖存取
+    mutable RecurrenceExpander m_expander;
+    FreeBusyEngine m_freeBusy;
+    ConflictDetector m_conflicts;
+    QVector<FreeBusyEngine::BusyInterval> m_conflictDirty;  // 待重新檢查衝突的範圍
+    bool m_conflictRecheckAll = false;
+    qint64 m_windowStartMs = 0;
+    qint64 m_windowEndMs = 0;
     QList<Task> m_allTasks;
+    QString m_syncScope;
 };
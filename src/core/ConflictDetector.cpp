@@ -0,0 +1,153 @@
+#include "ConflictDetector.h"
+#include <QHash>
+#include <numeric>
+#include <algorithm>
+
+namespace {
+
+constexpr qint64 kDayMs = 24LL * 60 * 60 * 1000;
+
+int findRoot(QVector<int>& parents, int index) {
+    while (parents[index] != index) {
+        parents[index] = parents[parents[index]];
+        index = parents[index];
+    }
+    return index;
+}
+
+} // namespace
+
+QList<ConflictDetector::Conflict> ConflictDetector::detect(QVector<Entry> entries, const Options& options) {
+    // 全天事件依政策移除或延伸為整天；沒有長度的事件不會衝突
+    for (Entry& entry : entries) {
+        if (entry.allDay && options.allDayPolicy == AllDayPolicy::Include && entry.endMs <= entry.startMs) {
+            entry.endMs = entry.startMs + kDayMs;
+        }
+    }
+    entries.erase(std::remove_if(entries.begin(), entries.end(), [&options](const Entry& entry) {
+        return entry.endMs <= entry.startMs ||
+               (entry.allDay && options.allDayPolicy == AllDayPolicy::Ignore);
+    }), entries.end());
+    
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.startMs != b.startMs ? a.startMs < b.startMs : a.endMs < b.endMs;
+    });
+    
+    auto comparable = [&options](const Entry& a, const Entry& b) {
+        // 同一會議在不同平台上的副本不算衝突
+        if (!a.iCalUid.isEmpty() && a.iCalUid == b.iCalUid && a.startMs == b.startMs) {
+            return false;
+        }
+        // 擁有者為帳號 email，Google 與 Graph 回傳的大小寫可能不同
+        if (options.ownerScope == OwnerScope::SameOwner &&
+            a.key.ownerId.compare(b.key.ownerId, Qt::CaseInsensitive) != 0) {
+            return false;
+        }
+        return !options.crossPlatformOnly || a.key.platform != b.key.platform;
+    };
+    
+    // 掃描線：active 保存尚未結束的事件，新事件與其中每一個都重疊
+    QVector<QPair<int, int>> pairs;
+    QVector<int> parents(entries.size());
+    std::iota(parents.begin(), parents.end(), 0);
+    QVector<int> active;
+    for (int i = 0; i < entries.size(); ++i) {
+        const qint64 start = entries[i].startMs;
+        active.erase(std::remove_if(active.begin(), active.end(), [&](int j) {
+            return entries[j].endMs <= start;
+        }), active.end());
+        
+        for (int j : active) {
+            if (comparable(entries[j], entries[i])) {
+                pairs.append({j, i});
+                parents[findRoot(parents, i)] = findRoot(parents, j);
+            }
+        }
+        active.append(i);
+    }
+    
+    // 依聯集的根分組，群組內保持開始時間順序
+    QHash<int, int> conflictByRoot;
+    QVector<QVector<int>> members;
+    QVector<int> localIndex(entries.size(), -1);
+    for (const auto& pair : pairs) {
+        const int root = findRoot(parents, pair.first);
+        if (!conflictByRoot.contains(root)) {
+            conflictByRoot.insert(root, members.size());
+            members.append(QVector<int>());
+        }
+    }
+    for (int i = 0; i < entries.size(); ++i) {
+        const auto it = conflictByRoot.constFind(findRoot(parents, i));
+        if (it != conflictByRoot.constEnd()) {
+            localIndex[i] = members[it.value()].size();
+            members[it.value()].append(i);
+        }
+    }
+    
+    QList<Conflict> result;
+    result.reserve(members.size());
+    for (const auto& group : members) {
+        Conflict conflict;
+        conflict.startMs = entries[group.first()].startMs;
+        conflict.endMs = conflict.startMs;
+        for (int index : group) {
+            conflict.events.append(entries[index].key);
+            conflict.endMs = std::max(conflict.endMs, entries[index].endMs);
+        }
+        result.append(conflict);
+    }
+    for (const auto& pair : pairs) {
+        const int group = conflictByRoot.value(findRoot(parents, pair.first));
+        result[group].pairs.append({localIndex[pair.first], localIndex[pair.second]});
+    }
+    
+    std::sort(result.begin(), result.end(), [](const Conflict& a, const Conflict& b) {
+        return a.startMs < b.startMs;
+    });
+    return result;
+}
+
+bool ConflictDetector::replaceRange(qint64 startMs, qint64 endMs, const QVector<Entry>& entries) {
+    QList<Conflict> removed;
+    for (auto it = m_conflicts.begin(); it != m_conflicts.end();) {
+        if (it->startMs < endMs && it->endMs > startMs) {
+            removed.append(*it);
+            it = m_conflicts.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    
+    const QList<Conflict> found = detect(entries, m_options);
+    for (const Conflict& conflict : found) {
+        const auto position = std::lower_bound(m_conflicts.begin(), m_conflicts.end(), conflict,
+                                               [](const Conflict& a, const Conflict& b) {
+            return a.startMs < b.startMs;
+        });
+        m_conflicts.insert(position, conflict);
+    }
+    return removed != found;
+}
+
+QSet<EventKey> ConflictDetector::conflictingEvents() const {
+    QSet<EventKey> keys;
+    for (const Conflict& conflict : m_conflicts) {
+        for (const EventKey& key : conflict.events) {
+            keys.insert(key);
+        }
+    }
+    return keys;
+}
+
+QPair<qint64, qint64> ConflictDetector::conflictSpan(qint64 startMs, qint64 endMs) const {
+    qint64 spanStart = startMs;
+    qint64 spanEnd = endMs;
+    for (const Conflict& conflict : m_conflicts) {
+        if (conflict.startMs < endMs && conflict.endMs > startMs) {
+            spanStart = std::min(spanStart, conflict.startMs);
+            spanEnd = std::max(spanEnd, conflict.endMs);
+        }
+    }
+    return {spanStart, spanEnd};
+}
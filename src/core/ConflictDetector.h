@@ -0,0 +1,76 @@
+#pragma once
+
+#include <QList>
+#include <QVector>
+#include <QPair>
+#include <QSet>
+#include "EventStore.h"
+
+// 時間衝突偵測 - 依開始時間排序後以掃描線找出重疊的事件對，並以聯集找出衝突群組。
+// 保存目前所有衝突；事件變更時由呼叫端只重新檢查受影響的時間範圍 (replaceRange)。
+// 時間皆為 UTC epoch 毫秒，區間為 [start, end)，首尾相接不算衝突。
+class ConflictDetector {
+public:
+    enum class AllDayPolicy {
+        Ignore,     // 全天事件不參與衝突偵測（預設）
+        Include     // 全天事件視為佔用整天
+    };
+    
+    enum class OwnerScope {
+        AllOwners,  // 所有已連接的行事曆視為同一人（預設）
+        SameOwner   // 只比較同一擁有者（帳號 email，不分大小寫）的事件
+    };
+    
+    struct Options {
+        AllDayPolicy allDayPolicy = AllDayPolicy::Ignore;
+        OwnerScope ownerScope = OwnerScope::AllOwners;
+        bool crossPlatformOnly = false;  // 只回報不同平台之間的衝突
+        
+        bool operator==(const Options& other) const {
+            return allDayPolicy == other.allDayPolicy && ownerScope == other.ownerScope &&
+                   crossPlatformOnly == other.crossPlatformOnly;
+        }
+    };
+    
+    struct Entry {
+        EventKey key;
+        qint64 startMs = 0;
+        qint64 endMs = 0;
+        bool allDay = false;
+        QString iCalUid;
+    };
+    
+    // 互相重疊的一群事件；pairs 為 events 中實際重疊的索引對
+    struct Conflict {
+        qint64 startMs = 0;
+        qint64 endMs = 0;
+        QList<EventKey> events;
+        QVector<QPair<int, int>> pairs;
+        
+        bool operator==(const Conflict& other) const {
+            return startMs == other.startMs && endMs == other.endMs && events == other.events &&
+                   pairs == other.pairs;
+        }
+    };
+    
+    void setOptions(const Options& options) { m_options = options; }
+    const Options& options() const { return m_options; }
+    
+    // 以 entries 重新偵測 [startMs, endMs)，取代與該範圍重疊的舊衝突。
+    // entries 必須涵蓋範圍內的所有事件，且範圍不可切開任何衝突群組。有變更時回傳 true
+    bool replaceRange(qint64 startMs, qint64 endMs, const QVector<Entry>& entries);
+    void clear() { m_conflicts.clear(); }
+    
+    // 依開始時間排序
+    const QList<Conflict>& conflicts() const { return m_conflicts; }
+    QSet<EventKey> conflictingEvents() const;
+    
+    // 與 [startMs, endMs) 重疊的衝突群組涵蓋的範圍聯集，供呼叫端擴大重新檢查的範圍
+    QPair<qint64, qint64> conflictSpan(qint64 startMs, qint64 endMs) const;
+    
+    static QList<Conflict> detect(QVector<Entry> entries, const Options& options);
+    
+private:
+    Options m_options;
+    QList<Conflict> m_conflicts;
+};
@@ -0,0 +1,96 @@
+#include "EventMerger.h"
+#include <QHash>
+#include <QSet>
+
+namespace {
+
+// 連接鍵：重複系列的各實例共用 UID，因此加上開始時間區分
+struct JoinKey {
+    QString uid;
+    qint64 startMs;
+    
+    bool operator==(const JoinKey& other) const {
+        return startMs == other.startMs && uid == other.uid;
+    }
+};
+
+size_t qHash(const JoinKey& key, size_t seed = 0) {
+    return qHashMulti(seed, key.uid, key.startMs);
+}
+
+} // namespace
+
+bool EventMerger::canMerge(const CalendarEvent& event) {
+    return !event.iCalUid.isEmpty() && !event.isCancelled && event.startTime.isValid();
+}
+
+bool EventMerger::preferredOver(const CalendarEvent& a, const CalendarEvent& b) {
+    if (a.platform != b.platform) {
+        return a.platform < b.platform;
+    }
+    if (a.ownerId != b.ownerId) {
+        return a.ownerId < b.ownerId;
+    }
+    return a.id < b.id;
+}
+
+void EventMerger::absorb(CalendarEvent& primary, const CalendarEvent& duplicate) {
+    primary.mergedSources.append({duplicate.platform, duplicate.ownerId, duplicate.id});
+    primary.mergedSources += duplicate.mergedSources;
+    
+    // 主要來源缺少的欄位由其他來源補上
+    if (primary.location.isEmpty()) {
+        primary.location = duplicate.location;
+    }
+    if (primary.description.isEmpty()) {
+        primary.description = duplicate.description;
+    }
+    
+    QSet<QString> known;
+    for (const QString& attendee : primary.attendees) {
+        known.insert(attendee.toLower());
+    }
+    for (const QString& attendee : duplicate.attendees) {
+        if (!known.contains(attendee.toLower())) {
+            known.insert(attendee.toLower());
+            primary.attendees.append(attendee);
+        }
+    }
+}
+
+QList<CalendarEvent> EventMerger::mergeDuplicates(const QList<CalendarEvent>& events, int* mergedCount) {
+    QList<CalendarEvent> result;
+    result.reserve(events.size());
+    QHash<JoinKey, int> indexByKey;
+    int merged = 0;
+    
+    for (const CalendarEvent& event : events) {
+        if (!canMerge(event)) {
+            result.append(event);
+            continue;
+        }
+        
+        const JoinKey key{event.iCalUid, event.startTime.toMSecsSinceEpoch()};
+        const auto it = indexByKey.constFind(key);
+        if (it == indexByKey.constEnd()) {
+            indexByKey.insert(key, result.size());
+            result.append(event);
+            continue;
+        }
+        
+        CalendarEvent& existing = result[it.value()];
+        if (preferredOver(event, existing)) {
+            CalendarEvent primary = event;
+            absorb(primary, existing);
+            existing = std::move(primary);
+        } else {
+            absorb(existing, event);
+        }
+        ++merged;
+    }
+    
+    if (mergedCount) {
+        *mergedCount = merged;
+    }
+    return result;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <QList>
+#include "CalendarEvent.h"
+
+// 跨平台重複會議合併 - 同一會議寄到 Google 與 Outlook 兩個身分時，
+// 以 (iCalUID, 開始時間) 做雜湊連接，合併為一個帶有多個來源的邏輯事件。
+class EventMerger {
+public:
+    // 保持輸入順序（以每組第一個事件的位置為準）；mergedCount 回傳被併入的事件數
+    static QList<CalendarEvent> mergeDuplicates(const QList<CalendarEvent>& events, int* mergedCount = nullptr);
+    
+    // 可參與合併的事件（有 UID、未取消、有開始時間）；相同 UID 與開始時間的事件視為同一會議
+    static bool canMerge(const CalendarEvent& event);
+    
+private:
+    // 決定保留哪個來源作為主要事件（依平台、擁有者與 id，結果與輸入順序無關）
+    static bool preferredOver(const CalendarEvent& a, const CalendarEvent& b);
+    static void absorb(CalendarEvent& primary, const CalendarEvent& duplicate);
+};
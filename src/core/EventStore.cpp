@@ -0,0 +1,522 @@
+#include "EventStore.h"
+#include <algorithm>
+
+namespace {
+
+// 背景搜尋時每處理這麼多筆檢查一次是否已取消
+constexpr int kCancelCheckInterval = 256;
+
+// 估計值：QString/QList 堆積表頭 16 bytes，QDateTime 帶時區時另有私有資料
+constexpr qint64 kHeapHeaderBytes = 16;
+constexpr qint64 kDateTimePrivateBytes = 48;
+
+qint64 stringBytes(const QString& text) {
+    return text.isEmpty() ? 0 : kHeapHeaderBytes + (text.capacity() + 1) * qint64(sizeof(QChar));
+}
+
+qint64 dateTimeBytes(const QDateTime& dateTime) {
+    return dateTime.isValid() && dateTime.timeSpec() != Qt::LocalTime && dateTime.timeSpec() != Qt::UTC
+        ? kDateTimePrivateBytes : 0;
+}
+
+} // namespace
+
+bool EventStore::ColdFields::operator==(const ColdFields& other) const {
+    return id == other.id &&
+           title == other.title &&
+           description == other.description &&
+           recurrenceRule == other.recurrenceRule &&
+           seriesMasterId == other.seriesMasterId &&
+           iCalUid == other.iCalUid &&
+           attendeeRefs == other.attendeeRefs &&
+           originalStartMs == other.originalStartMs &&
+           zoneRef == other.zoneRef &&
+           color == other.color;
+}
+
+EventStore::UpsertResult EventStore::upsert(const CalendarEvent& event, int* slotOut) {
+    const EventKey key = EventKey::of(event);
+    
+    auto it = m_slotByKey.constFind(key);
+    if (it != m_slotByKey.constEnd()) {
+        const int slot = it.value();
+        if (slotOut) {
+            *slotOut = slot;
+        }
+        // 先只查詢字串池來比較，未變更的事件不會在池中留下新字串
+        Row row = toRow(event, false);
+        if (rowEquals(slot, row)) {
+            return UpsertResult::Unchanged;
+        }
+        if (!row.pooled) {
+            row = toRow(event, true);
+        }
+        
+        ++m_revision;
+        const QStringList oldText = textFieldsOf(slot);
+        untrackSeries(slot);
+        writeRow(slot, std::move(row));
+        trackSeries(slot);
+        indexSlot(slot);
+        
+        // 文字欄位未變更時不必更新 n-gram 索引
+        const QStringList newText = textFieldsOf(slot);
+        if (newText != oldText) {
+            m_textIndex.remove(slot, oldText);
+            m_textIndex.insert(slot, newText);
+        }
+        return UpsertResult::Updated;
+    }
+    
+    ++m_revision;
+    const int slot = allocateSlot();
+    writeRow(slot, toRow(event, true));
+    
+    m_slotByKey.insert(key, slot);
+    m_slotsById.insert(event.id, slot);
+    trackSeries(slot);
+    indexSlot(slot);
+    m_textIndex.insert(slot, textFieldsOf(slot));
+    
+    if (slotOut) {
+        *slotOut = slot;
+    }
+    return UpsertResult::Inserted;
+}
+
+bool EventStore::remove(const EventKey& key) {
+    const int slot = slotOf(key);
+    if (slot < 0) {
+        return false;
+    }
+    
+    removeSlot(slot);
+    return true;
+}
+
+QList<CalendarEvent> EventStore::removeById(Platform platform, const QString& id) {
+    QList<CalendarEvent> removed;
+    
+    const QList<int> candidates = m_slotsById.values(id);
+    for (int slot : candidates) {
+        if (platformAt(slot) == platform) {
+            removed.append(at(slot));
+            removeSlot(slot);
+        }
+    }
+    
+    return removed;
+}
+
+void EventStore::clear() {
+    m_startMs.clear();
+    m_endMs.clear();
+    m_ownerRefs.clear();
+    m_locationRefs.clear();
+    m_platforms.clear();
+    m_flags.clear();
+    m_cold.clear();
+    m_strings.clear();
+    m_refsByFolded.clear();
+    m_zones.clear();
+    m_zoneRefs.clear();
+    m_freeSlots.clear();
+    m_slotByKey.clear();
+    m_slotsById.clear();
+    m_masterSlots.clear();
+    m_slotsBySeries.clear();
+    m_timeIndex.clear();
+    m_textIndex.clear();
+    ++m_revision;
+}
+
+CalendarEvent EventStore::at(int slot) const {
+    const ColdFields& cold = m_cold[slot];
+    const quint8 flags = m_flags[slot];
+    
+    CalendarEvent event;
+    event.id = cold.id;
+    event.title = cold.title;
+    event.description = cold.description;
+    if (flags & HasStart) {
+        event.startTime = toDateTime(m_startMs[slot], cold.zoneRef);
+    }
+    if (flags & HasEnd) {
+        event.endTime = toDateTime(m_endMs[slot], cold.zoneRef);
+    }
+    event.location = m_strings.value(m_locationRefs[slot]);
+    event.platform = static_cast<Platform>(m_platforms[slot]);
+    event.ownerId = m_strings.value(m_ownerRefs[slot]);
+    event.isAllDay = flags & AllDay;
+    event.attendees.reserve(cold.attendeeRefs.size());
+    for (quint32 ref : cold.attendeeRefs) {
+        event.attendees.append(m_strings.value(ref));
+    }
+    event.recurrenceRule = cold.recurrenceRule;
+    event.seriesMasterId = cold.seriesMasterId;
+    event.iCalUid = cold.iCalUid;
+    if (flags & HasOriginalStart) {
+        event.originalStartTime = toDateTime(cold.originalStartMs, cold.zoneRef);
+    }
+    event.isCancelled = flags & Cancelled;
+    if (flags & HasColor) {
+        event.color = QColor::fromRgba(cold.color);
+    }
+    return event;
+}
+
+std::optional<CalendarEvent> EventStore::findById(const QString& id) const {
+    const int slot = slotOfId(id);
+    if (slot < 0) {
+        return std::nullopt;
+    }
+    return at(slot);
+}
+
+QList<CalendarEvent> EventStore::events() const {
+    QList<CalendarEvent> result = eventsForSlots(m_timeIndex.slotsInOrder());
+    
+    // 沒有開始時間的事件；系列主事件與已取消的實例需經展開才會顯示
+    for (int slot = 0; slot < m_flags.size(); ++slot) {
+        if ((m_flags[slot] & Used) && !(m_flags[slot] & HasStart)) {
+            result.append(at(slot));
+        }
+    }
+    
+    return result;
+}
+
+QList<CalendarEvent> EventStore::exceptionsOf(const CalendarEvent& master) const {
+    QList<CalendarEvent> result;
+    for (auto it = m_slotsBySeries.constFind(master.id);
+         it != m_slotsBySeries.constEnd() && it.key() == master.id; ++it) {
+        const int slot = it.value();
+        if (platformAt(slot) == master.platform && ownerIdAt(slot) == master.ownerId) {
+            result.append(at(slot));
+        }
+    }
+    return result;
+}
+
+bool EventStore::hasSeriesMaster(const CalendarEvent& event) const {
+    if (event.seriesMasterId.isEmpty()) {
+        return false;
+    }
+    const int slot = slotOf({event.platform, event.ownerId, event.seriesMasterId});
+    return slot >= 0 && m_masterSlots.contains(slot);
+}
+
+bool EventStore::hasSeriesMasterAt(int slot) const {
+    const QString& seriesMasterId = m_cold[slot].seriesMasterId;
+    if (seriesMasterId.isEmpty()) {
+        return false;
+    }
+    const int masterSlot = slotOf({platformAt(slot), ownerIdAt(slot), seriesMasterId});
+    return masterSlot >= 0 && m_masterSlots.contains(masterSlot);
+}
+
+QList<CalendarEvent> EventStore::eventsForSlots(const QList<int>& slotIds) const {
+    QList<CalendarEvent> result;
+    result.reserve(slotIds.size());
+    for (int slot : slotIds) {
+        result.append(at(slot));
+    }
+    return result;
+}
+
+QList<int> EventStore::searchText(const QString& query, const std::function<bool()>& isCanceled) const {
+    bool exact = false;
+    const QVector<int> candidates = m_textIndex.candidates(query, &exact);
+    const QString folded = TrigramIndex::fold(query);
+    
+    QList<int> result;
+    result.reserve(candidates.size());
+    for (int i = 0; i < candidates.size(); ++i) {
+        if (isCanceled && i % kCancelCheckInterval == 0 && isCanceled()) {
+            return {};
+        }
+        const int slot = candidates[i];
+        if (m_flags[slot] & Cancelled) {
+            continue;
+        }
+        // 長查詢的 trigram 交集可能誤判，需比對原文確認
+        if (exact || slotContains(slot, folded)) {
+            result.append(slot);
+        }
+    }
+    
+    std::sort(result.begin(), result.end(), [this](int a, int b) {
+        const bool aHasStart = m_flags[a] & HasStart;
+        const bool bHasStart = m_flags[b] & HasStart;
+        if (aHasStart != bHasStart) {
+            return aHasStart;
+        }
+        return m_startMs[a] != m_startMs[b] ? m_startMs[a] < m_startMs[b] : a < b;
+    });
+    
+    return result;
+}
+
+QList<int> EventStore::filterText(const QList<int>& slotIds, const QString& query,
+                                  const std::function<bool()>& isCanceled) const {
+    const QString folded = TrigramIndex::fold(query);
+    
+    QList<int> result;
+    for (int i = 0; i < slotIds.size(); ++i) {
+        if (isCanceled && i % kCancelCheckInterval == 0 && isCanceled()) {
+            return {};
+        }
+        const int slot = slotIds[i];
+        if (isValid(slot) && slotContains(slot, folded)) {
+            result.append(slot);
+        }
+    }
+    
+    return result;
+}
+
+QStringList EventStore::textFieldsOf(int slot) const {
+    const ColdFields& cold = m_cold[slot];
+    QStringList fields = {cold.title, m_strings.value(m_locationRefs[slot]), cold.description};
+    for (quint32 ref : cold.attendeeRefs) {
+        fields.append(m_strings.value(ref));
+    }
+    return fields;
+}
+
+bool EventStore::slotContains(int slot, const QString& foldedQuery) const {
+    const QStringList fields = textFieldsOf(slot);
+    return std::any_of(fields.cbegin(), fields.cend(), [&foldedQuery](const QString& field) {
+        return TrigramIndex::fold(field).contains(foldedQuery);
+    });
+}
+
+EventStore::MemoryStats EventStore::memoryStats() const {
+    MemoryStats stats;
+    stats.events = size();
+    
+    // 熱欄位陣列
+    stats.compactBytes += m_startMs.capacity() * qint64(sizeof(qint64));
+    stats.compactBytes += m_endMs.capacity() * qint64(sizeof(qint64));
+    stats.compactBytes += m_ownerRefs.capacity() * qint64(sizeof(quint32));
+    stats.compactBytes += m_locationRefs.capacity() * qint64(sizeof(quint32));
+    stats.compactBytes += m_platforms.capacity() * qint64(sizeof(quint8));
+    stats.compactBytes += m_flags.capacity() * qint64(sizeof(quint8));
+    stats.compactBytes += m_cold.capacity() * qint64(sizeof(ColdFields));
+    stats.compactBytes += m_strings.bytesUsed();
+    // 小寫索引：已是小寫的字串與字串池共用內容，只計算雜湊表本身
+    stats.compactBytes += m_refsByFolded.capacity() * qint64(sizeof(QString) + sizeof(quint32) + sizeof(size_t));
+    
+    for (int slot = 0; slot < m_flags.size(); ++slot) {
+        if (!(m_flags[slot] & Used)) {
+            continue;
+        }
+        const ColdFields& cold = m_cold[slot];
+        stats.compactBytes += stringBytes(cold.id) + stringBytes(cold.title) +
+                              stringBytes(cold.description) + stringBytes(cold.recurrenceRule) +
+                              stringBytes(cold.seriesMasterId) + stringBytes(cold.iCalUid);
+        if (!cold.attendeeRefs.isEmpty()) {
+            stats.compactBytes += kHeapHeaderBytes + cold.attendeeRefs.capacity() * qint64(sizeof(quint32));
+        }
+        stats.expandedBytes += estimateEventBytes(at(slot));
+    }
+    
+    return stats;
+}
+
+qint64 EventStore::estimateEventBytes(const CalendarEvent& event) {
+    // 每個字串都各自持有一份內容（來自 JSON 解析時不會共用）
+    qint64 bytes = sizeof(CalendarEvent);
+    bytes += stringBytes(event.id) + stringBytes(event.title) + stringBytes(event.description) +
+             stringBytes(event.location) + stringBytes(event.ownerId) +
+             stringBytes(event.recurrenceRule) + stringBytes(event.seriesMasterId) +
+             stringBytes(event.iCalUid);
+    bytes += dateTimeBytes(event.startTime) + dateTimeBytes(event.endTime) +
+             dateTimeBytes(event.originalStartTime);
+    if (!event.attendees.isEmpty()) {
+        bytes += kHeapHeaderBytes + event.attendees.capacity() * qint64(sizeof(QString));
+        for (const QString& attendee : event.attendees) {
+            bytes += stringBytes(attendee);
+        }
+    }
+    return bytes;
+}
+
+quint32 EventStore::stringRef(const QString& text, bool internStrings, Row& row) {
+    if (internStrings) {
+        const int poolSize = m_strings.size();
+        const quint32 id = m_strings.intern(text);
+        if (m_strings.size() != poolSize) {
+            m_refsByFolded.insert(text.toLower(), id);
+        }
+        return id;
+    }
+    const qint64 id = m_strings.find(text);
+    if (id < 0) {
+        row.pooled = false;
+        return kMissingRef;
+    }
+    return quint32(id);
+}
+
+EventStore::Row EventStore::toRow(const CalendarEvent& event, bool internStrings) {
+    Row row;
+    row.platform = static_cast<quint8>(event.platform);
+    row.ownerRef = stringRef(event.ownerId, internStrings, row);
+    row.locationRef = stringRef(event.location, internStrings, row);
+    row.flags = Used;
+    
+    if (event.startTime.isValid()) {
+        row.flags |= HasStart;
+        row.startMs = event.startTime.toMSecsSinceEpoch();
+        row.cold.zoneRef = zoneRef(event.startTime, internStrings, row);
+    }
+    if (event.endTime.isValid()) {
+        row.flags |= HasEnd;
+        row.endMs = event.endTime.toMSecsSinceEpoch();
+    }
+    if (event.originalStartTime.isValid()) {
+        row.flags |= HasOriginalStart;
+        row.cold.originalStartMs = event.originalStartTime.toMSecsSinceEpoch();
+    }
+    if (event.isAllDay) {
+        row.flags |= AllDay;
+    }
+    if (event.isCancelled) {
+        row.flags |= Cancelled;
+    }
+    if (event.isSeriesMaster()) {
+        row.flags |= SeriesMaster;
+    }
+    if (event.color.isValid()) {
+        row.flags |= HasColor;
+        row.cold.color = event.color.rgba();
+    }
+    
+    row.cold.id = event.id;
+    row.cold.title = event.title;
+    row.cold.description = event.description;
+    row.cold.recurrenceRule = event.recurrenceRule;
+    row.cold.seriesMasterId = event.seriesMasterId;
+    row.cold.iCalUid = event.iCalUid;
+    row.cold.attendeeRefs.reserve(event.attendees.size());
+    for (const QString& attendee : event.attendees) {
+        row.cold.attendeeRefs.append(stringRef(attendee, internStrings, row));
+    }
+    
+    return row;
+}
+
+bool EventStore::rowEquals(int slot, const Row& row) const {
+    // 先比較熱欄位，多數未變更的事件不必比較字串
+    return m_startMs[slot] == row.startMs &&
+           m_endMs[slot] == row.endMs &&
+           m_ownerRefs[slot] == row.ownerRef &&
+           m_locationRefs[slot] == row.locationRef &&
+           m_platforms[slot] == row.platform &&
+           m_flags[slot] == row.flags &&
+           m_cold[slot] == row.cold;
+}
+
+void EventStore::writeRow(int slot, Row&& row) {
+    m_startMs[slot] = row.startMs;
+    m_endMs[slot] = row.endMs;
+    m_ownerRefs[slot] = row.ownerRef;
+    m_locationRefs[slot] = row.locationRef;
+    m_platforms[slot] = row.platform;
+    m_flags[slot] = row.flags;
+    m_cold[slot] = std::move(row.cold);
+}
+
+quint16 EventStore::zoneRef(const QDateTime& dateTime, bool internZones, Row& row) {
+    if (dateTime.timeSpec() == Qt::LocalTime) {
+        return 0;
+    }
+    
+    const QTimeZone zone = dateTime.timeZone();
+    const QByteArray zoneId = zone.id();
+    auto it = m_zoneRefs.constFind(zoneId);
+    if (it != m_zoneRefs.constEnd()) {
+        return it.value();
+    }
+    if (!internZones) {
+        row.pooled = false;
+        return kMissingZoneRef;
+    }
+    
+    if (m_zones.isEmpty()) {
+        m_zones.append(QTimeZone());
+    }
+    const quint16 ref = quint16(m_zones.size());
+    m_zones.append(zone);
+    m_zoneRefs.insert(zoneId, ref);
+    return ref;
+}
+
+QDateTime EventStore::toDateTime(qint64 ms, quint16 zoneRef) const {
+    if (zoneRef == 0) {
+        return QDateTime::fromMSecsSinceEpoch(ms);
+    }
+    return QDateTime::fromMSecsSinceEpoch(ms, m_zones[zoneRef]);
+}
+
+int EventStore::allocateSlot() {
+    if (!m_freeSlots.isEmpty()) {
+        return m_freeSlots.takeLast();
+    }
+    
+    const int slot = m_flags.size();
+    m_startMs.append(0);
+    m_endMs.append(0);
+    m_ownerRefs.append(0);
+    m_locationRefs.append(0);
+    m_platforms.append(0);
+    m_flags.append(0);
+    m_cold.append(ColdFields());
+    return slot;
+}
+
+void EventStore::removeSlot(int slot) {
+    m_slotByKey.remove({platformAt(slot), ownerIdAt(slot), idAt(slot)});
+    m_slotsById.remove(idAt(slot), slot);
+    untrackSeries(slot);
+    m_timeIndex.remove(slot);
+    m_textIndex.remove(slot, textFieldsOf(slot));
+    ++m_revision;
+    
+    // 釋放字串等資源，slot 留待重用
+    m_cold[slot] = ColdFields();
+    m_flags[slot] = 0;
+    m_freeSlots.append(slot);
+}
+
+void EventStore::trackSeries(int slot) {
+    if (m_flags[slot] & SeriesMaster) {
+        m_masterSlots.insert(slot);
+    }
+    const QString& seriesMasterId = m_cold[slot].seriesMasterId;
+    if (!seriesMasterId.isEmpty()) {
+        m_slotsBySeries.insert(seriesMasterId, slot);
+    }
+}
+
+void EventStore::untrackSeries(int slot) {
+    m_masterSlots.remove(slot);
+    const QString& seriesMasterId = m_cold[slot].seriesMasterId;
+    if (!seriesMasterId.isEmpty()) {
+        m_slotsBySeries.remove(seriesMasterId, slot);
+    }
+}
+
+void EventStore::indexSlot(int slot) {
+    const quint8 flags = m_flags[slot];
+    // 系列主事件只代表規則，已取消的實例不顯示，都不放入時間索引
+    if (!(flags & HasStart) || (flags & (SeriesMaster | Cancelled))) {
+        m_timeIndex.remove(slot);
+        return;
+    }
+    
+    const qint64 start = m_startMs[slot];
+    const qint64 end = (flags & HasEnd) ? m_endMs[slot] : start;
+    m_timeIndex.insert(start, end, slot);
+}
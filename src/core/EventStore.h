@@ -0,0 +1,200 @@
+#pragma once
+
+#include <QList>
+#include <QVector>
+#include <QHash>
+#include <QMultiHash>
+#include <QSet>
+#include <QTimeZone>
+#include <optional>
+#include <functional>
+#include "CalendarEvent.h"
+#include "EventTimeIndex.h"
+#include "StringPool.h"
+#include "TrigramIndex.h"
+
+// 事件唯一鍵 (platform, ownerId, id)
+struct EventKey {
+    Platform platform = Platform::Google;
+    QString ownerId;
+    QString id;
+    
+    static EventKey of(const CalendarEvent& event) {
+        return {event.platform, event.ownerId, event.id};
+    }
+    
+    bool operator==(const EventKey& other) const {
+        return platform == other.platform && ownerId == other.ownerId && id == other.id;
+    }
+};
+
+inline size_t qHash(const EventKey& key, size_t seed = 0) {
+    return qHashMulti(seed, static_cast<int>(key.platform), key.ownerId, key.id);
+}
+
+// 事件儲存區 - 以 EventKey 做 upsert，依 id 為 O(1) 查找。
+// 每個事件佔用一個穩定的 slot，刪除後的 slot 會被回收；時間索引隨寫入同步維護。
+// 內部以 structure-of-arrays 緊湊儲存：時間為 UTC epoch 毫秒，擁有者、地點與參與者
+// 以字串池 id 表示；完整的 CalendarEvent 只在需要時才組出。
+class EventStore {
+public:
+    enum class UpsertResult {
+        Inserted,
+        Updated,
+        Unchanged
+    };
+    
+    // 記憶體用量（估計值），expanded 為以 CalendarEvent 物件保存時的用量
+    struct MemoryStats {
+        int events = 0;
+        qint64 compactBytes = 0;
+        qint64 expandedBytes = 0;
+        
+        double compactBytesPerEvent() const { return events > 0 ? double(compactBytes) / events : 0.0; }
+        double expandedBytesPerEvent() const { return events > 0 ? double(expandedBytes) / events : 0.0; }
+    };
+    
+    UpsertResult upsert(const CalendarEvent& event, int* slotOut = nullptr);
+    bool remove(const EventKey& key);
+    QList<CalendarEvent> removeById(Platform platform, const QString& id);
+    void clear();
+    
+    int slotOf(const EventKey& key) const { return m_slotByKey.value(key, -1); }
+    int slotOfId(const QString& id) const { return m_slotsById.value(id, -1); }
+    bool isValid(int slot) const { return slot >= 0 && slot < m_flags.size() && (m_flags[slot] & Used); }
+    
+    // 組出完整事件
+    CalendarEvent at(int slot) const;
+    std::optional<CalendarEvent> findById(const QString& id) const;
+    
+    // 熱欄位直接讀取，不需組出事件
+    qint64 startMsAt(int slot) const { return m_startMs[slot]; }
+    qint64 endMsAt(int slot) const { return m_endMs[slot]; }
+    Platform platformAt(int slot) const { return static_cast<Platform>(m_platforms[slot]); }
+    const QString& idAt(int slot) const { return m_cold[slot].id; }
+    const QString& ownerIdAt(int slot) const { return m_strings.value(m_ownerRefs[slot]); }
+    const QString& iCalUidAt(int slot) const { return m_cold[slot].iCalUid; }
+    bool isAllDayAt(int slot) const { return m_flags[slot] & AllDay; }
+    bool isSeriesMasterAt(int slot) const { return m_flags[slot] & SeriesMaster; }
+    
+    // 擁有者與參與者的字串池 id，以 strings() 取回文字
+    quint32 ownerRefAt(int slot) const { return m_ownerRefs[slot]; }
+    const QVector<quint32>& attendeeRefsAt(int slot) const { return m_cold[slot].attendeeRefs; }
+    const StringPool& strings() const { return m_strings; }
+    
+    // 不分大小寫地找出字串池中所有等於 text 的 id（同一 email 可能有不同大小寫寫法）
+    QList<quint32> foldedRefs(const QString& text) const { return m_refsByFolded.values(text.toLower()); }
+    
+    int size() const { return m_slotByKey.size(); }
+    bool isEmpty() const { return m_slotByKey.isEmpty(); }
+    
+    // 所有事件，依開始時間排序（沒有開始時間的事件排在最後）
+    QList<CalendarEvent> events() const;
+    QList<CalendarEvent> eventsForSlots(const QList<int>& slotIds) const;
+    
+    const EventTimeIndex& timeIndex() const { return m_timeIndex; }
+    
+    // 標題、地點、描述與參與者的子字串搜尋（不分大小寫），結果依開始時間排序。
+    // isCanceled 回傳 true 時提早結束並回傳空結果
+    QList<int> searchText(const QString& query, const std::function<bool()>& isCanceled = {}) const;
+    
+    // 只在給定的 slot 中比對（保留原順序），用於查詢字串延長時縮小前次結果
+    QList<int> filterText(const QList<int>& slotIds, const QString& query,
+                          const std::function<bool()>& isCanceled = {}) const;
+    
+    // 每次內容變更都會遞增，用於判斷先前取得的 slot 是否仍有效
+    quint64 revision() const { return m_revision; }
+    
+    // 重複系列：主事件不在時間索引中，由呼叫端展開
+    QList<int> seriesMasterSlots() const { return m_masterSlots.values(); }
+    QList<CalendarEvent> exceptionsOf(const CalendarEvent& master) const;
+    bool hasSeriesMaster(const CalendarEvent& event) const;
+    bool hasSeriesMasterAt(int slot) const;
+    
+    MemoryStats memoryStats() const;
+    static qint64 estimateEventBytes(const CalendarEvent& event);
+    
+private:
+    enum Flag : quint8 {
+        Used = 0x01,
+        AllDay = 0x02,
+        Cancelled = 0x04,
+        SeriesMaster = 0x08,
+        HasStart = 0x10,
+        HasEnd = 0x20,
+        HasOriginalStart = 0x40,
+        HasColor = 0x80
+    };
+    
+    // 不常讀取的欄位
+    struct ColdFields {
+        QString id;
+        QString title;
+        QString description;
+        QString recurrenceRule;
+        QString seriesMasterId;
+        QString iCalUid;
+        QVector<quint32> attendeeRefs;
+        qint64 originalStartMs = 0;
+        QRgb color = 0;
+        quint16 zoneRef = 0;    // 0 表示本地時間
+        
+        // 與 CalendarEvent 相同，只比較時間點而不比較時區
+        bool operator==(const ColdFields& other) const;
+    };
+    
+    // 一筆事件的緊湊表示，用於寫入與比較
+    struct Row {
+        qint64 startMs = 0;
+        qint64 endMs = 0;
+        quint32 ownerRef = 0;
+        quint32 locationRef = 0;
+        quint8 platform = 0;
+        quint8 flags = 0;
+        ColdFields cold;
+        bool pooled = true;     // 所有字串與時區都已在池中；否則缺少的以 kMissingRef / kMissingZoneRef 表示
+    };
+    
+    // 不在字串池（時區表）中的字串與時區，只出現在比較用的 Row，不會寫入
+    static constexpr quint32 kMissingRef = 0xffffffffu;
+    static constexpr quint16 kMissingZoneRef = 0xffff;
+    
+    // internStrings 為 false 時只查詢字串池與時區表，不新增項目
+    Row toRow(const CalendarEvent& event, bool internStrings);
+    quint32 stringRef(const QString& text, bool internStrings, Row& row);
+    bool rowEquals(int slot, const Row& row) const;
+    void writeRow(int slot, Row&& row);
+    quint16 zoneRef(const QDateTime& dateTime, bool internZones, Row& row);
+    QDateTime toDateTime(qint64 ms, quint16 zoneRef) const;
+    
+    void removeSlot(int slot);
+    void indexSlot(int slot);
+    void trackSeries(int slot);
+    void untrackSeries(int slot);
+    int allocateSlot();
+    QStringList textFieldsOf(int slot) const;
+    bool slotContains(int slot, const QString& foldedQuery) const;
+    
+    // 熱欄位（structure-of-arrays）
+    QVector<qint64> m_startMs;
+    QVector<qint64> m_endMs;
+    QVector<quint32> m_ownerRefs;
+    QVector<quint32> m_locationRefs;
+    QVector<quint8> m_platforms;
+    QVector<quint8> m_flags;
+    QVector<ColdFields> m_cold;
+    
+    StringPool m_strings;
+    QMultiHash<QString, quint32> m_refsByFolded;   // 小寫字串 -> 字串池 id，隨新字串加入維護
+    QVector<QTimeZone> m_zones;
+    QHash<QByteArray, quint16> m_zoneRefs;
+    
+    QVector<int> m_freeSlots;
+    QHash<EventKey, int> m_slotByKey;
+    QMultiHash<QString, int> m_slotsById;
+    QSet<int> m_masterSlots;
+    QMultiHash<QString, int> m_slotsBySeries;
+    EventTimeIndex m_timeIndex;
+    TrigramIndex m_textIndex;
+    quint64 m_revision = 0;
+};
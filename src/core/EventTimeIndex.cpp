@@ -0,0 +1,168 @@
+#include "EventTimeIndex.h"
+#include <algorithm>
+
+void EventTimeIndex::clear() {
+    m_entries.clear();
+    m_positionBySlot.clear();
+    m_rootLevel = -1;
+    m_dirty = false;
+}
+
+void EventTimeIndex::insert(qint64 startMs, qint64 endMs, int slot) {
+    remove(slot);
+    
+    // 零長度事件視為 1 毫秒，避免半開區間查詢漏掉
+    if (endMs <= startMs) {
+        endMs = startMs + 1;
+    }
+    
+    m_positionBySlot.insert(slot, m_entries.size());
+    m_entries.append({startMs, endMs, endMs, slot});
+    m_dirty = true;
+}
+
+void EventTimeIndex::remove(int slot) {
+    auto it = m_positionBySlot.find(slot);
+    if (it == m_positionBySlot.end()) {
+        return;
+    }
+    
+    m_entries[it.value()].slot = -1;
+    m_positionBySlot.erase(it);
+    m_dirty = true;
+}
+
+void EventTimeIndex::ensureBuilt() const {
+    if (!m_dirty) {
+        return;
+    }
+    m_dirty = false;
+    
+    m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(),
+                                   [](const Entry& e) { return e.slot < 0; }),
+                    m_entries.end());
+    std::sort(m_entries.begin(), m_entries.end(), [](const Entry& a, const Entry& b) {
+        return a.start < b.start || (a.start == b.start && a.slot < b.slot);
+    });
+    
+    const qint64 n = m_entries.size();
+    m_positionBySlot.clear();
+    m_positionBySlot.reserve(n);
+    for (qint64 i = 0; i < n; ++i) {
+        m_positionBySlot.insert(m_entries[i].slot, int(i));
+    }
+    
+    m_rootLevel = -1;
+    if (n == 0) {
+        return;
+    }
+    
+    // 由下而上計算每層節點的子樹最大結束時間；
+    // 第 k 層節點的索引低 k 位元全為 1，葉節點為偶數索引
+    qint64 lastIndex = 0;
+    qint64 last = 0;
+    for (qint64 i = 0; i < n; i += 2) {
+        lastIndex = i;
+        last = m_entries[i].maxEnd = m_entries[i].end;
+    }
+    
+    int k = 1;
+    for (; (qint64(1) << k) <= n; ++k) {
+        const qint64 x = qint64(1) << (k - 1);
+        const qint64 i0 = (x << 1) - 1;
+        const qint64 step = x << 2;
+        
+        for (qint64 i = i0; i < n; i += step) {
+            const qint64 leftMax = m_entries[i - x].maxEnd;
+            const qint64 rightMax = (i + x < n) ? m_entries[i + x].maxEnd : last;
+            m_entries[i].maxEnd = std::max({m_entries[i].end, leftMax, rightMax});
+        }
+        
+        lastIndex = ((lastIndex >> k) & 1) ? lastIndex - x : lastIndex + x;
+        if (lastIndex < n && m_entries[lastIndex].maxEnd > last) {
+            last = m_entries[lastIndex].maxEnd;
+        }
+    }
+    
+    m_rootLevel = k - 1;
+}
+
+QList<int> EventTimeIndex::overlapping(qint64 startMs, qint64 endMs) const {
+    ensureBuilt();
+    
+    QList<int> result;
+    if (m_rootLevel < 0 || startMs >= endMs) {
+        return result;
+    }
+    
+    struct StackItem {
+        int level;
+        qint64 node;
+        bool leftDone;
+    };
+    
+    const qint64 n = m_entries.size();
+    StackItem stack[64];
+    int top = 0;
+    stack[top++] = {m_rootLevel, (qint64(1) << m_rootLevel) - 1, false};
+    
+    // 由上而下走訪；左子樹的最大結束時間不超過查詢起點時整棵略過
+    while (top > 0) {
+        const StackItem z = stack[--top];
+        
+        if (z.level <= 3) {
+            // 小型子樹直接線性掃描
+            const qint64 i0 = z.node >> z.level << z.level;
+            qint64 i1 = i0 + (qint64(1) << (z.level + 1)) - 1;
+            if (i1 > n) i1 = n;
+            for (qint64 i = i0; i < i1 && m_entries[i].start < endMs; ++i) {
+                if (startMs < m_entries[i].end) {
+                    result.append(m_entries[i].slot);
+                }
+            }
+        } else if (!z.leftDone) {
+            const qint64 left = z.node - (qint64(1) << (z.level - 1));
+            stack[top++] = {z.level, z.node, true};
+            if (left >= n || m_entries[left].maxEnd > startMs) {
+                stack[top++] = {z.level - 1, left, false};
+            }
+        } else if (z.node < n && m_entries[z.node].start < endMs) {
+            if (startMs < m_entries[z.node].end) {
+                result.append(m_entries[z.node].slot);
+            }
+            stack[top++] = {z.level - 1, z.node + (qint64(1) << (z.level - 1)), false};
+        }
+    }
+    
+    return result;
+}
+
+QList<int> EventTimeIndex::at(qint64 instantMs) const {
+    return overlapping(instantMs, instantMs + 1);
+}
+
+QList<int> EventTimeIndex::nextAfter(qint64 afterMs, int count) const {
+    ensureBuilt();
+    
+    QList<int> result;
+    auto it = std::lower_bound(m_entries.cbegin(), m_entries.cend(), afterMs,
+                               [](const Entry& e, qint64 t) { return e.start < t; });
+    
+    for (; it != m_entries.cend() && result.size() < count; ++it) {
+        result.append(it->slot);
+    }
+    
+    return result;
+}
+
+QList<int> EventTimeIndex::slotsInOrder() const {
+    ensureBuilt();
+    
+    QList<int> result;
+    result.reserve(m_entries.size());
+    for (const Entry& entry : m_entries) {
+        result.append(entry.slot);
+    }
+    
+    return result;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <QList>
+#include <QVector>
+#include <QHash>
+
+// 事件時間索引 - 以開始時間排序的陣列實作隱式增廣區間樹，
+// 每個節點記錄其子樹的最大結束時間。時間皆為 UTC epoch 毫秒，區間為 [start, end)。
+// 新增與移除只標記變更，於下次查詢時重建 (O(n log n))；查詢為 O(log n + k)。
+class EventTimeIndex {
+public:
+    void clear();
+    void insert(qint64 startMs, qint64 endMs, int slot);
+    void remove(int slot);
+    bool contains(int slot) const { return m_positionBySlot.contains(slot); }
+    int size() const { return m_positionBySlot.size(); }
+    
+    // 與 [startMs, endMs) 重疊的 slot，依開始時間排序
+    QList<int> overlapping(qint64 startMs, qint64 endMs) const;
+    
+    // 在 instantMs 時刻進行中的 slot
+    QList<int> at(qint64 instantMs) const;
+    
+    // 開始時間 >= afterMs 的前 count 個 slot
+    QList<int> nextAfter(qint64 afterMs, int count) const;
+    
+    // 所有 slot，依開始時間排序
+    QList<int> slotsInOrder() const;
+    
+private:
+    struct Entry {
+        qint64 start;
+        qint64 end;
+        qint64 maxEnd;  // 子樹最大結束時間
+        int slot;       // -1 表示已移除
+    };
+    
+    void ensureBuilt() const;
+    
+    mutable QVector<Entry> m_entries;
+    mutable QHash<int, int> m_positionBySlot;
+    mutable int m_rootLevel = -1;
+    mutable bool m_dirty = false;
+};
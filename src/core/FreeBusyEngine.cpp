@@ -0,0 +1,195 @@
+#include "FreeBusyEngine.h"
+#include <algorithm>
+
+qint64 FreeBusyEngine::dayOf(qint64 ms) {
+    // 向下取整，負的 epoch 也落在正確的日期
+    return ms >= 0 ? ms / kDayMs : -((-ms + kDayMs - 1) / kDayMs);
+}
+
+void FreeBusyEngine::invalidate(qint64 startMs, qint64 endMs) {
+    if (m_days.isEmpty()) {
+        return;
+    }
+    
+    const qint64 firstDay = dayOf(startMs);
+    const qint64 lastDay = dayOf(std::max(startMs, endMs - 1));
+    
+    // 範圍很長時改為走訪快取本身
+    if (lastDay - firstDay + 1 > m_days.size()) {
+        for (auto it = m_days.begin(); it != m_days.end();) {
+            it = (it.key() >= firstDay && it.key() <= lastDay) ? m_days.erase(it) : std::next(it);
+        }
+        return;
+    }
+    
+    for (qint64 day = firstDay; day <= lastDay; ++day) {
+        m_days.remove(day);
+    }
+}
+
+QVector<FreeBusyEngine::BusyInterval> FreeBusyEngine::merge(QVector<BusyInterval> intervals) {
+    if (intervals.size() < 2) {
+        return intervals;
+    }
+    
+    std::sort(intervals.begin(), intervals.end(), [](const BusyInterval& a, const BusyInterval& b) {
+        return a.startMs < b.startMs;
+    });
+    
+    QVector<BusyInterval> result;
+    result.reserve(intervals.size());
+    result.append(intervals.first());
+    for (int i = 1; i < intervals.size(); ++i) {
+        BusyInterval& last = result.last();
+        if (intervals[i].startMs <= last.endMs) {
+            last.endMs = std::max(last.endMs, intervals[i].endMs);
+        } else {
+            result.append(intervals[i]);
+        }
+    }
+    return result;
+}
+
+void FreeBusyEngine::loadDays(qint64 firstDay, qint64 lastDay) const {
+    const qint64 rangeStart = firstDay * kDayMs;
+    const qint64 rangeEnd = (lastDay + 1) * kDayMs;
+    
+    QHash<qint64, Day> loaded;
+    for (qint64 day = firstDay; day <= lastDay; ++day) {
+        loaded.insert(day, Day());
+    }
+    
+    // 連續缺少的日期只向資料來源查詢一次，再依日期裁切分配
+    const QVector<SourceInterval> source = m_provider ? m_provider(rangeStart, rangeEnd)
+                                                      : QVector<SourceInterval>();
+    for (const SourceInterval& interval : source) {
+        const qint64 start = std::max(interval.startMs, rangeStart);
+        const qint64 end = std::min(interval.endMs, rangeEnd);
+        if (start >= end) {
+            continue;
+        }
+        for (qint64 day = dayOf(start); day <= dayOf(end - 1); ++day) {
+            const qint64 dayStart = day * kDayMs;
+            loaded[day].intervals.append({std::max(start, dayStart), std::min(end, dayStart + kDayMs),
+                                          interval.ownerId});
+        }
+    }
+    
+    for (auto it = loaded.begin(); it != loaded.end(); ++it) {
+        Day& entry = it.value();
+        std::sort(entry.intervals.begin(), entry.intervals.end(),
+                  [](const SourceInterval& a, const SourceInterval& b) { return a.startMs < b.startMs; });
+        
+        QVector<BusyInterval> plain;
+        plain.reserve(entry.intervals.size());
+        for (const SourceInterval& interval : entry.intervals) {
+            plain.append({interval.startMs, interval.endMs});
+        }
+        entry.merged = merge(std::move(plain));
+        m_days.insert(it.key(), std::move(entry));
+    }
+}
+
+void FreeBusyEngine::ensureDays(qint64 firstDay, qint64 lastDay) const {
+    if (m_days.size() + (lastDay - firstDay + 1) > kMaxCachedDays) {
+        m_days.clear();
+    }
+    
+    qint64 runStart = -1;
+    bool inRun = false;
+    for (qint64 day = firstDay; day <= lastDay + 1; ++day) {
+        const bool missing = day <= lastDay && !m_days.contains(day);
+        if (missing && !inRun) {
+            runStart = day;
+            inRun = true;
+        } else if (!missing && inRun) {
+            loadDays(runStart, day - 1);
+            inRun = false;
+        }
+    }
+}
+
+QVector<FreeBusyEngine::BusyInterval> FreeBusyEngine::busy(qint64 startMs, qint64 endMs,
+                                                           const QString& ownerId) const {
+    QVector<BusyInterval> result;
+    if (startMs >= endMs) {
+        return result;
+    }
+    
+    const qint64 firstDay = dayOf(startMs);
+    const qint64 lastDay = dayOf(endMs - 1);
+    ensureDays(firstDay, lastDay);
+    
+    for (qint64 day = firstDay; day <= lastDay; ++day) {
+        const Day& entry = m_days[day];
+        QVector<BusyInterval> dayIntervals;
+        if (ownerId.isEmpty()) {
+            dayIntervals = entry.merged;
+        } else {
+            for (const SourceInterval& interval : entry.intervals) {
+                if (interval.ownerId == ownerId) {
+                    dayIntervals.append({interval.startMs, interval.endMs});
+                }
+            }
+            dayIntervals = merge(std::move(dayIntervals));
+        }
+        
+        // 各日結果已排序且互不重疊，只需處理跨日相接的區間
+        for (const BusyInterval& interval : dayIntervals) {
+            const BusyInterval clipped{std::max(interval.startMs, startMs), std::min(interval.endMs, endMs)};
+            if (clipped.startMs >= clipped.endMs) {
+                continue;
+            }
+            if (!result.isEmpty() && clipped.startMs <= result.last().endMs) {
+                result.last().endMs = std::max(result.last().endMs, clipped.endMs);
+            } else {
+                result.append(clipped);
+            }
+        }
+    }
+    
+    return result;
+}
+
+QHash<QString, QVector<FreeBusyEngine::BusyInterval>> FreeBusyEngine::busyByOwner(qint64 startMs,
+                                                                                  qint64 endMs) const {
+    QHash<QString, QVector<BusyInterval>> result;
+    if (startMs >= endMs) {
+        return result;
+    }
+    
+    const qint64 firstDay = dayOf(startMs);
+    const qint64 lastDay = dayOf(endMs - 1);
+    ensureDays(firstDay, lastDay);
+    
+    for (qint64 day = firstDay; day <= lastDay; ++day) {
+        for (const SourceInterval& interval : m_days[day].intervals) {
+            const qint64 start = std::max(interval.startMs, startMs);
+            const qint64 end = std::min(interval.endMs, endMs);
+            if (start < end) {
+                result[interval.ownerId].append({start, end});
+            }
+        }
+    }
+    
+    for (auto it = result.begin(); it != result.end(); ++it) {
+        it.value() = merge(std::move(it.value()));
+    }
+    return result;
+}
+
+QBitArray FreeBusyEngine::busySlots(qint64 startMs, qint64 endMs, qint64 slotMs,
+                                    const QString& ownerId) const {
+    if (slotMs <= 0 || startMs >= endMs) {
+        return QBitArray();
+    }
+    
+    const int slotCount = int((endMs - startMs + slotMs - 1) / slotMs);
+    QBitArray slotBits(slotCount);
+    for (const BusyInterval& interval : busy(startMs, endMs, ownerId)) {
+        const int first = int((interval.startMs - startMs) / slotMs);
+        const int last = int((interval.endMs - startMs - 1) / slotMs);
+        slotBits.fill(true, first, last + 1);
+    }
+    return slotBits;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QVector>
+#include <QHash>
+#include <QString>
+#include <QBitArray>
+#include <functional>
+
+// 忙碌時段引擎 - 合併所有行事曆的忙碌區間，時間皆為 UTC epoch 毫秒，區間為 [start, end)。
+// 結果依 UTC 日期分段快取；事件變更時只讓受影響的日期失效，下次查詢才重新計算。
+class FreeBusyEngine {
+public:
+    struct BusyInterval {
+        qint64 startMs;
+        qint64 endMs;
+        
+        bool operator==(const BusyInterval& other) const {
+            return startMs == other.startMs && endMs == other.endMs;
+        }
+    };
+    
+    // 由資料來源提供的原始區間（可重疊、未排序）
+    struct SourceInterval {
+        qint64 startMs;
+        qint64 endMs;
+        QString ownerId;
+    };
+    
+    // 回傳與 [startMs, endMs) 重疊的所有忙碌事件
+    using Provider = std::function<QVector<SourceInterval>(qint64 startMs, qint64 endMs)>;
+    
+    void setProvider(Provider provider) { m_provider = std::move(provider); clear(); }
+    
+    // 讓與 [startMs, endMs) 重疊的日期失效
+    void invalidate(qint64 startMs, qint64 endMs);
+    void clear() { m_days.clear(); }
+    
+    // 合併後的忙碌區間；ownerId 非空時只計算該擁有者
+    QVector<BusyInterval> busy(qint64 startMs, qint64 endMs, const QString& ownerId = QString()) const;
+    
+    // 每個擁有者各自合併的忙碌區間
+    QHash<QString, QVector<BusyInterval>> busyByOwner(qint64 startMs, qint64 endMs) const;
+    
+    // 以固定長度切割 [startMs, endMs)，與忙碌區間重疊的時段設為 1
+    QBitArray busySlots(qint64 startMs, qint64 endMs, qint64 slotMs, const QString& ownerId = QString()) const;
+    
+    // 排序後掃描合併重疊或相接的區間
+    static QVector<BusyInterval> merge(QVector<BusyInterval> intervals);
+    
+private:
+    struct Day {
+        QVector<SourceInterval> intervals;  // 裁切至當日，依開始時間排序
+        QVector<BusyInterval> merged;
+    };
+    
+    static constexpr qint64 kDayMs = 24LL * 60 * 60 * 1000;
+    static constexpr int kMaxCachedDays = 400;
+    
+    static qint64 dayOf(qint64 ms);
+    void ensureDays(qint64 firstDay, qint64 lastDay) const;
+    void loadDays(qint64 firstDay, qint64 lastDay) const;
+    
+    Provider m_provider;
+    mutable QHash<qint64, Day> m_days;
+};
@@ -0,0 +1,242 @@
+#include "MeetingSlotFinder.h"
+#include <QtAlgorithms>
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+constexpr qint64 kMinuteMs = 60 * 1000;
+constexpr qint64 kDayMs = 24 * 60 * kMinuteMs;
+
+// 鄰接忙碌時段（前後無緩衝）的扣分，以參與者比例計算
+constexpr double kAdjacentPenalty = 0.5;
+
+int wordCount(int slotCount) {
+    return (slotCount + 63) / 64;
+}
+
+} // namespace
+
+void MeetingSlotFinder::fillRange(Bits& bits, int first, int last) {
+    const int firstWord = first / 64;
+    const int lastWord = last / 64;
+    const quint64 firstMask = ~quint64(0) << (first % 64);
+    const quint64 lastMask = ~quint64(0) >> (63 - last % 64);
+    
+    if (firstWord == lastWord) {
+        bits[firstWord] |= firstMask & lastMask;
+        return;
+    }
+    bits[firstWord] |= firstMask;
+    for (int word = firstWord + 1; word < lastWord; ++word) {
+        bits[word] = ~quint64(0);
+    }
+    bits[lastWord] |= lastMask;
+}
+
+bool MeetingSlotFinder::testBit(const Bits& bits, int index) {
+    if (index < 0 || index >= bits.size() * 64) {
+        return false;
+    }
+    return (bits[index / 64] >> (index % 64)) & 1;
+}
+
+MeetingSlotFinder::Bits MeetingSlotFinder::fromIntervals(const QVector<FreeBusyEngine::BusyInterval>& intervals,
+                                                         qint64 startMs, qint64 slotMs, int slotCount) {
+    Bits bits(wordCount(slotCount), 0);
+    const qint64 endMs = startMs + slotMs * slotCount;
+    
+    for (const auto& interval : intervals) {
+        const qint64 start = std::max(interval.startMs, startMs);
+        const qint64 end = std::min(interval.endMs, endMs);
+        if (start >= end) {
+            continue;
+        }
+        fillRange(bits, int((start - startMs) / slotMs), int((end - startMs - 1) / slotMs));
+    }
+    return bits;
+}
+
+MeetingSlotFinder::Bits MeetingSlotFinder::workingMask(const WorkingHours& hours, qint64 startMs,
+                                                       qint64 slotMs, int slotCount) {
+    Bits mask(wordCount(slotCount), 0);
+    const QTimeZone zone = hours.timeZone.isValid() ? hours.timeZone : QTimeZone::systemTimeZone();
+    const qint64 endMs = startMs + slotMs * slotCount;
+    
+    // 從前一天開始，涵蓋跨午夜的工作時間
+    QDate date = QDateTime::fromMSecsSinceEpoch(startMs, zone).date().addDays(-1);
+    const QDate lastDate = QDateTime::fromMSecsSinceEpoch(endMs, zone).date();
+    for (; date <= lastDate; date = date.addDays(1)) {
+        if (!hours.days.contains(date.dayOfWeek())) {
+            continue;
+        }
+        
+        const qint64 dayStart = QDateTime(date, hours.start, zone).toMSecsSinceEpoch();
+        const QDate endDate = hours.end <= hours.start ? date.addDays(1) : date;
+        const qint64 dayEnd = QDateTime(endDate, hours.end, zone).toMSecsSinceEpoch();
+        if (dayEnd <= startMs || dayStart >= endMs) {
+            continue;
+        }
+        
+        // 只取完整落在工作時間內的時段
+        const qint64 first = dayStart <= startMs ? 0 : (dayStart - startMs + slotMs - 1) / slotMs;
+        const qint64 last = std::min<qint64>(slotCount, (dayEnd - startMs) / slotMs);
+        if (first < last) {
+            fillRange(mask, int(first), int(last - 1));
+        }
+    }
+    return mask;
+}
+
+MeetingSlotFinder::Bits MeetingSlotFinder::shiftedDown(const Bits& bits, int count) {
+    const int words = bits.size();
+    const int wordShift = count / 64;
+    const int bitShift = count % 64;
+    
+    Bits result(words, 0);
+    for (int word = 0; word + wordShift < words; ++word) {
+        quint64 value = bits[word + wordShift] >> bitShift;
+        if (bitShift != 0 && word + wordShift + 1 < words) {
+            value |= bits[word + wordShift + 1] << (64 - bitShift);
+        }
+        result[word] = value;
+    }
+    return result;
+}
+
+MeetingSlotFinder::Bits MeetingSlotFinder::runsOf(const Bits& bits, int length) {
+    // 倍增：result 的每個位元代表長度 covered 的連續空閒，每次至多加倍
+    Bits result = bits;
+    int covered = 1;
+    while (covered < length) {
+        const int step = std::min(covered, length - covered);
+        const Bits shifted = shiftedDown(result, step);
+        for (int word = 0; word < result.size(); ++word) {
+            result[word] &= shifted[word];
+        }
+        covered += step;
+    }
+    return result;
+}
+
+QList<MeetingSlotFinder::Candidate> MeetingSlotFinder::find(
+    const Request& request, const QVector<QVector<FreeBusyEngine::BusyInterval>>& busy) {
+    QList<Candidate> result;
+    const qint64 startMs = request.start.toMSecsSinceEpoch();
+    const qint64 endMs = request.end.toMSecsSinceEpoch();
+    const qint64 slotMs = qint64(request.slotMinutes) * kMinuteMs;
+    const qint64 durationMs = qint64(request.durationMinutes) * kMinuteMs;
+    if (slotMs <= 0 || durationMs <= 0 || startMs >= endMs || request.maxResults <= 0) {
+        return result;
+    }
+    
+    const int slotCount = int((endMs - startMs) / slotMs);
+    const int length = int((durationMs + slotMs - 1) / slotMs);
+    if (length > slotCount) {
+        return result;
+    }
+    
+    const int attendeeCount = request.attendees.size();
+    const Bits allowed = workingMask(request.workingHours, startMs, slotMs, slotCount);
+    
+    // 逐字組交集所有參與者的空閒時段
+    QVector<Bits> busyBits(attendeeCount);
+    Bits common = allowed;
+    for (int i = 0; i < attendeeCount; ++i) {
+        busyBits[i] = fromIntervals(i < busy.size() ? busy[i] : QVector<FreeBusyEngine::BusyInterval>(),
+                                    startMs, slotMs, slotCount);
+        for (int word = 0; word < common.size(); ++word) {
+            common[word] &= ~busyBits[i][word];
+        }
+    }
+    const Bits fullRuns = runsOf(common, length);
+    
+    struct Scored {
+        int position;
+        int missing;
+        double score;
+    };
+    QVector<Scored> scored;
+    
+    // 越早越好（每晚一天加 1 分），與他人會議緊鄰則扣分
+    const double slotsPerDay = double(kDayMs) / slotMs;
+    auto scoreOf = [&](int position) {
+        int adjacent = 0;
+        for (const Bits& bits : busyBits) {
+            if (testBit(bits, position - 1) || testBit(bits, position + length)) {
+                ++adjacent;
+            }
+        }
+        const double adjacentRatio = attendeeCount > 0 ? double(adjacent) / attendeeCount : 0.0;
+        return position / slotsPerDay + kAdjacentPenalty * adjacentRatio;
+    };
+    auto forEachBit = [](const Bits& bits, auto&& visit) {
+        for (int word = 0; word < bits.size(); ++word) {
+            for (quint64 value = bits[word]; value != 0; value &= value - 1) {
+                visit(word * 64 + int(qCountTrailingZeroBits(value)));
+            }
+        }
+    };
+    
+    int fullCount = 0;
+    forEachBit(fullRuns, [&](int position) {
+        scored.append({position, 0, scoreOf(position)});
+        ++fullCount;
+    });
+    
+    // 全員可出席的時段不足時，以可出席人數最多的時段補足
+    QVector<Bits> attendeeRuns;
+    if (fullCount < request.maxResults && attendeeCount > 1) {
+        attendeeRuns.resize(attendeeCount);
+        QVector<int> available(slotCount, 0);
+        for (int i = 0; i < attendeeCount; ++i) {
+            Bits free = allowed;
+            for (int word = 0; word < free.size(); ++word) {
+                free[word] &= ~busyBits[i][word];
+            }
+            attendeeRuns[i] = runsOf(free, length);
+            forEachBit(attendeeRuns[i], [&](int position) { ++available[position]; });
+        }
+        for (int position = 0; position < slotCount; ++position) {
+            if (available[position] > 0 && available[position] < attendeeCount) {
+                scored.append({position, attendeeCount - available[position], scoreOf(position)});
+            }
+        }
+    }
+    
+    std::sort(scored.begin(), scored.end(), [](const Scored& a, const Scored& b) {
+        if (a.missing != b.missing) {
+            return a.missing < b.missing;
+        }
+        return a.score != b.score ? a.score < b.score : a.position < b.position;
+    });
+    
+    // 依序挑選互不重疊的候選時段
+    QVector<int> chosen;
+    for (const Scored& entry : scored) {
+        if (chosen.size() >= request.maxResults) {
+            break;
+        }
+        const bool overlaps = std::any_of(chosen.cbegin(), chosen.cend(), [&](int position) {
+            return std::abs(position - entry.position) < length;
+        });
+        if (overlaps) {
+            continue;
+        }
+        chosen.append(entry.position);
+        
+        Candidate candidate;
+        candidate.start = request.start.addMSecs(entry.position * slotMs);
+        candidate.end = candidate.start.addMSecs(durationMs);
+        candidate.score = entry.score;
+        if (entry.missing > 0) {
+            for (int i = 0; i < attendeeCount; ++i) {
+                if (!testBit(attendeeRuns[i], entry.position)) {
+                    candidate.unavailable.append(request.attendees[i]);
+                }
+            }
+        }
+        result.append(candidate);
+    }
+    return result;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QDateTime>
+#include <QTime>
+#include <QTimeZone>
+#include <QVector>
+#include <QStringList>
+#include "FreeBusyEngine.h"
+
+// 會議時段搜尋 - 每位參與者在查詢視窗內的空閒時段以 64 位元字組的位元集表示，
+// 逐字組交集後以位移 AND 找出長度足夠的連續空閒，再依評分挑出互不重疊的候選時段。
+class MeetingSlotFinder {
+public:
+    struct WorkingHours {
+        QTime start = QTime(9, 0);
+        QTime end = QTime(18, 0);
+        QList<int> days = {1, 2, 3, 4, 5};  // 1 = 星期一 ... 7 = 星期日
+        QTimeZone timeZone = QTimeZone::systemTimeZone();
+    };
+    
+    struct Request {
+        QStringList attendees;          // email，不分大小寫
+        QDateTime start;
+        QDateTime end;
+        int durationMinutes = 30;
+        int slotMinutes = 15;           // 時段粒度，候選時間都對齊於 start 加上整數個時段
+        WorkingHours workingHours;
+        int maxResults = 10;
+    };
+    
+    struct Candidate {
+        QDateTime start;
+        QDateTime end;
+        QStringList unavailable;        // 此時段有衝突的參與者，全員可出席時為空
+        double score = 0.0;             // 缺席人數相同時越小越好
+    };
+    
+    // 第 i 個時段對應第 i / 64 個字組的第 i % 64 位元
+    using Bits = QVector<quint64>;
+    
+    // busy[i] 為 request.attendees[i] 的忙碌區間；全員可出席的時段優先，
+    // 不足 maxResults 時再以缺席人數最少的時段補足
+    static QList<Candidate> find(const Request& request,
+                                 const QVector<QVector<FreeBusyEngine::BusyInterval>>& busy);
+    
+    // 與區間重疊的時段設為 1
+    static Bits fromIntervals(const QVector<FreeBusyEngine::BusyInterval>& intervals,
+                              qint64 startMs, qint64 slotMs, int slotCount);
+    
+    // 完整落在工作時間內的時段設為 1
+    static Bits workingMask(const WorkingHours& hours, qint64 startMs, qint64 slotMs, int slotCount);
+    
+    // 第 i 位元為 1 表示 bits 的第 i 到 i + length - 1 位元皆為 1
+    static Bits runsOf(const Bits& bits, int length);
+    
+private:
+    static Bits shiftedDown(const Bits& bits, int count);
+    static void fillRange(Bits& bits, int first, int last);
+    static bool testBit(const Bits& bits, int index);
+};
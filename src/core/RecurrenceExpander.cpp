@@ -0,0 +1,534 @@
+#include "RecurrenceExpander.h"
+#include <QStringList>
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+// 沒有任何符合日期時的保護上限，避免如 2 月 30 日這類規則無限迴圈
+constexpr int kMaxPeriods = 100000;
+
+int weekdayFromCode(const QString& code) {
+    static const QStringList codes = {"MO", "TU", "WE", "TH", "FR", "SA", "SU"};
+    const int index = codes.indexOf(code.toUpper());
+    return index >= 0 ? index + 1 : 0;
+}
+
+// 解析 iCalendar 日期時間：yyyyMMdd、yyyyMMddTHHmmss 或 yyyyMMddTHHmmssZ
+QDateTime parseIcalDateTime(const QString& value, const QTimeZone& zone, bool* dateOnly = nullptr) {
+    if (dateOnly) {
+        *dateOnly = false;
+    }
+    
+    if (value.size() == 8) {
+        if (dateOnly) {
+            *dateOnly = true;
+        }
+        return QDateTime(QDate::fromString(value, "yyyyMMdd"), QTime(0, 0), zone);
+    }
+    
+    if (value.endsWith('Z')) {
+        QDateTime utc = QDateTime::fromString(value.left(value.size() - 1), "yyyyMMdd'T'HHmmss");
+        utc.setTimeZone(QTimeZone::utc());
+        return utc;
+    }
+    
+    const QDateTime local = QDateTime::fromString(value, "yyyyMMdd'T'HHmmss");
+    return QDateTime(local.date(), local.time(), zone);
+}
+
+// 解析 "EXDATE;TZID=Asia/Taipei:20240105T090000,20240112T090000" 這類行
+QList<QPair<QDateTime, bool>> parseDateList(const QString& line, const QTimeZone& defaultZone) {
+    QList<QPair<QDateTime, bool>> result;
+    
+    const int colon = line.indexOf(':');
+    if (colon < 0) {
+        return result;
+    }
+    
+    QTimeZone zone = defaultZone;
+    const QStringList params = line.left(colon).split(';');
+    for (const QString& param : params) {
+        if (param.startsWith("TZID=", Qt::CaseInsensitive)) {
+            QTimeZone tz(param.mid(5).toUtf8());
+            if (tz.isValid()) {
+                zone = tz;
+            }
+        }
+    }
+    
+    const QStringList values = line.mid(colon + 1).split(',', Qt::SkipEmptyParts);
+    for (const QString& value : values) {
+        bool dateOnly = false;
+        const QDateTime dt = parseIcalDateTime(value.trimmed(), zone, &dateOnly);
+        if (dt.isValid()) {
+            result.append({dt, dateOnly});
+        }
+    }
+    
+    return result;
+}
+
+// 月份內符合 BYMONTHDAY / BYDAY 的日期
+QList<QDate> datesInMonth(const QDate& firstOfMonth, const RecurrenceRule& rule, int defaultDay) {
+    const int daysInMonth = firstOfMonth.daysInMonth();
+    QList<QDate> monthDays;
+    QList<QDate> weekDays;
+    
+    for (int day : rule.byMonthDay) {
+        const int d = day > 0 ? day : daysInMonth + day + 1;
+        if (d >= 1 && d <= daysInMonth) {
+            monthDays.append(firstOfMonth.addDays(d - 1));
+        }
+    }
+    
+    for (const auto& wd : rule.byDay) {
+        const int firstOffset = (wd.weekday - firstOfMonth.dayOfWeek() + 7) % 7;
+        if (wd.ordinal == 0) {
+            for (int d = firstOffset; d < daysInMonth; d += 7) {
+                weekDays.append(firstOfMonth.addDays(d));
+            }
+        } else if (wd.ordinal > 0) {
+            const int d = firstOffset + (wd.ordinal - 1) * 7;
+            if (d < daysInMonth) {
+                weekDays.append(firstOfMonth.addDays(d));
+            }
+        } else {
+            const QDate last = firstOfMonth.addDays(daysInMonth - 1);
+            const int lastOffset = (last.dayOfWeek() - wd.weekday + 7) % 7;
+            const int d = daysInMonth - 1 - lastOffset + (wd.ordinal + 1) * 7;
+            if (d >= 0) {
+                weekDays.append(firstOfMonth.addDays(d));
+            }
+        }
+    }
+    
+    QList<QDate> result;
+    if (!rule.byMonthDay.isEmpty() && !rule.byDay.isEmpty()) {
+        // 兩者並存時 BYDAY 用來限制 BYMONTHDAY
+        for (const QDate& date : monthDays) {
+            if (weekDays.contains(date)) {
+                result.append(date);
+            }
+        }
+    } else if (!rule.byMonthDay.isEmpty()) {
+        result = monthDays;
+    } else if (!rule.byDay.isEmpty()) {
+        result = weekDays;
+    } else if (defaultDay <= daysInMonth) {
+        result.append(firstOfMonth.addDays(defaultDay - 1));
+    }
+    
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+bool matchesDailyFilters(const QDate& date, const RecurrenceRule& rule) {
+    if (!rule.byMonth.isEmpty() && !rule.byMonth.contains(date.month())) {
+        return false;
+    }
+    if (!rule.byMonthDay.isEmpty()) {
+        const int fromEnd = date.day() - date.daysInMonth() - 1;
+        if (!rule.byMonthDay.contains(date.day()) && !rule.byMonthDay.contains(fromEnd)) {
+            return false;
+        }
+    }
+    if (!rule.byDay.isEmpty()) {
+        const bool match = std::any_of(rule.byDay.cbegin(), rule.byDay.cend(),
+                                       [&date](const RecurrenceRule::WeekdayNum& wd) {
+            return wd.weekday == date.dayOfWeek();
+        });
+        if (!match) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 第 period 個週期的第一天
+QDate periodStart(const RecurrenceRule& rule, const QDate& dtstart, int period) {
+    const int step = period * rule.interval;
+    switch (rule.frequency) {
+        case RecurrenceRule::Frequency::Daily:
+            return dtstart.addDays(step);
+        case RecurrenceRule::Frequency::Weekly:
+            return dtstart.addDays(-((dtstart.dayOfWeek() - rule.weekStart + 7) % 7) + qint64(step) * 7);
+        case RecurrenceRule::Frequency::Monthly:
+            return QDate(dtstart.year(), dtstart.month(), 1).addMonths(step);
+        case RecurrenceRule::Frequency::Yearly:
+            return QDate(dtstart.year() + step, 1, 1);
+        default:
+            return QDate();
+    }
+}
+
+// 第 period 個週期內的候選日期（已排序）
+QList<QDate> candidatesForPeriod(const RecurrenceRule& rule, const QDate& dtstart, int period) {
+    const QDate first = periodStart(rule, dtstart, period);
+    QList<QDate> result;
+    
+    switch (rule.frequency) {
+        case RecurrenceRule::Frequency::Daily:
+            if (matchesDailyFilters(first, rule)) {
+                result.append(first);
+            }
+            break;
+        case RecurrenceRule::Frequency::Weekly: {
+            QList<int> weekdays;
+            for (const auto& wd : rule.byDay) {
+                weekdays.append(wd.weekday);
+            }
+            if (weekdays.isEmpty()) {
+                weekdays.append(dtstart.dayOfWeek());
+            }
+            for (int weekday : weekdays) {
+                const QDate date = first.addDays((weekday - rule.weekStart + 7) % 7);
+                if (rule.byMonth.isEmpty() || rule.byMonth.contains(date.month())) {
+                    result.append(date);
+                }
+            }
+            std::sort(result.begin(), result.end());
+            break;
+        }
+        case RecurrenceRule::Frequency::Monthly:
+            if (rule.byMonth.isEmpty() || rule.byMonth.contains(first.month())) {
+                result = datesInMonth(first, rule, dtstart.day());
+            }
+            break;
+        case RecurrenceRule::Frequency::Yearly: {
+            QList<int> months = rule.byMonth;
+            if (months.isEmpty()) {
+                months.append(dtstart.month());
+            }
+            std::sort(months.begin(), months.end());
+            for (int month : months) {
+                result += datesInMonth(QDate(first.year(), month, 1), rule, dtstart.day());
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    
+    if (!rule.bySetPos.isEmpty() && !result.isEmpty()) {
+        // BYSETPOS 從整個週期的候選日期中挑選，例如 BYDAY=MO,TU,WE,TH,FR;BYSETPOS=-1 為每月最後一個工作日
+        QList<QDate> selected;
+        const int size = int(result.size());
+        for (int pos : rule.bySetPos) {
+            const int index = pos > 0 ? pos - 1 : size + pos;
+            if (pos != 0 && index >= 0 && index < size && !selected.contains(result[index])) {
+                selected.append(result[index]);
+            }
+        }
+        std::sort(selected.begin(), selected.end());
+        result = selected;
+    }
+    
+    return result;
+}
+
+// 沒有 COUNT 時可直接跳到查詢範圍附近的週期
+int firstPeriodNear(const RecurrenceRule& rule, const QDate& dtstart, const QDate& target) {
+    if (rule.count > 0 || target <= dtstart) {
+        return 0;
+    }
+    
+    qint64 units = 0;
+    switch (rule.frequency) {
+        case RecurrenceRule::Frequency::Daily:
+            units = dtstart.daysTo(target);
+            break;
+        case RecurrenceRule::Frequency::Weekly:
+            units = dtstart.daysTo(target) / 7;
+            break;
+        case RecurrenceRule::Frequency::Monthly:
+            units = (target.year() - dtstart.year()) * 12 + (target.month() - dtstart.month());
+            break;
+        case RecurrenceRule::Frequency::Yearly:
+            units = target.year() - dtstart.year();
+            break;
+        default:
+            break;
+    }
+    
+    return int(std::max<qint64>(0, units / rule.interval - 1));
+}
+
+size_t hashDateTime(size_t seed, const QDateTime& dateTime) {
+    // 時區影響展開結果，一併計入
+    return qHashMulti(seed, dateTime.toMSecsSinceEpoch(), dateTime.timeZone().id());
+}
+
+size_t hashEvent(size_t seed, const CalendarEvent& event) {
+    seed = qHashMulti(seed, event.id, event.title, event.description, event.location,
+                      static_cast<int>(event.platform), event.ownerId, event.isAllDay,
+                      event.attendees, event.recurrenceRule, event.seriesMasterId,
+                      event.isCancelled, event.iCalUid, event.color.rgba());
+    seed = hashDateTime(seed, event.startTime);
+    seed = hashDateTime(seed, event.endTime);
+    seed = hashDateTime(seed, event.originalStartTime);
+    for (const EventSource& source : event.mergedSources) {
+        seed = qHashMulti(seed, static_cast<int>(source.platform), source.ownerId, source.id);
+    }
+    return seed;
+}
+
+} // namespace
+
+RecurrenceRule RecurrenceRule::parse(const QString& text, const QTimeZone& zone) {
+    RecurrenceRule rule;
+    
+    const QStringList lines = text.split('\n', Qt::SkipEmptyParts);
+    for (const QString& rawLine : lines) {
+        const QString line = rawLine.trimmed();
+        
+        if (line.startsWith("RRULE:", Qt::CaseInsensitive)) {
+            const QStringList parts = line.mid(6).split(';', Qt::SkipEmptyParts);
+            for (const QString& part : parts) {
+                const QString name = part.section('=', 0, 0).toUpper();
+                const QString value = part.section('=', 1);
+                
+                if (name == "FREQ") {
+                    const QString freq = value.toUpper();
+                    if (freq == "DAILY") rule.frequency = Frequency::Daily;
+                    else if (freq == "WEEKLY") rule.frequency = Frequency::Weekly;
+                    else if (freq == "MONTHLY") rule.frequency = Frequency::Monthly;
+                    else if (freq == "YEARLY") rule.frequency = Frequency::Yearly;
+                } else if (name == "INTERVAL") {
+                    rule.interval = std::max(1, value.toInt());
+                } else if (name == "COUNT") {
+                    rule.count = value.toInt();
+                } else if (name == "UNTIL") {
+                    bool dateOnly = false;
+                    rule.until = parseIcalDateTime(value, zone, &dateOnly);
+                    if (dateOnly) {
+                        // 只有日期時整天都包含在內
+                        rule.until = rule.until.addDays(1).addMSecs(-1);
+                    }
+                } else if (name == "BYDAY") {
+                    for (const QString& item : value.split(',', Qt::SkipEmptyParts)) {
+                        WeekdayNum wd;
+                        wd.weekday = weekdayFromCode(item.right(2));
+                        wd.ordinal = item.left(item.size() - 2).toInt();
+                        if (wd.weekday > 0) {
+                            rule.byDay.append(wd);
+                        }
+                    }
+                } else if (name == "BYMONTHDAY") {
+                    for (const QString& item : value.split(',', Qt::SkipEmptyParts)) {
+                        rule.byMonthDay.append(item.toInt());
+                    }
+                } else if (name == "BYMONTH") {
+                    for (const QString& item : value.split(',', Qt::SkipEmptyParts)) {
+                        rule.byMonth.append(item.toInt());
+                    }
+                } else if (name == "BYSETPOS") {
+                    for (const QString& item : value.split(',', Qt::SkipEmptyParts)) {
+                        rule.bySetPos.append(item.toInt());
+                    }
+                } else if (name == "WKST") {
+                    const int weekday = weekdayFromCode(value);
+                    if (weekday > 0) {
+                        rule.weekStart = weekday;
+                    }
+                }
+            }
+        } else if (line.startsWith("EXDATE", Qt::CaseInsensitive)) {
+            for (const auto& entry : parseDateList(line, zone)) {
+                if (entry.second) {
+                    rule.exDays.insert(entry.first.date());
+                } else {
+                    rule.exDates.insert(entry.first.toMSecsSinceEpoch());
+                }
+            }
+        } else if (line.startsWith("RDATE", Qt::CaseInsensitive)) {
+            for (const auto& entry : parseDateList(line, zone)) {
+                rule.rDates.append(entry.first);
+            }
+        }
+    }
+    
+    return rule;
+}
+
+QString RecurrenceExpander::occurrenceId(const CalendarEvent& master, const QDateTime& occurrenceStart) {
+    if (master.isAllDay) {
+        return master.id + "_" + occurrenceStart.date().toString("yyyyMMdd");
+    }
+    return master.id + "_" + occurrenceStart.toUTC().toString("yyyyMMdd'T'HHmmss'Z'");
+}
+
+QString RecurrenceExpander::seriesKeyOf(const CalendarEvent& master) {
+    return QString("%1|%2|%3").arg(static_cast<int>(master.platform)).arg(master.ownerId, master.id);
+}
+
+size_t RecurrenceExpander::signatureOf(const CalendarEvent& master, const QList<CalendarEvent>& overrides) {
+    // 實例複製主事件與例外的所有欄位，任何欄位變更都要讓快取失效
+    size_t seed = hashEvent(0, master);
+    for (const auto& item : overrides) {
+        seed = hashEvent(seed, item);
+    }
+    return seed;
+}
+
+void RecurrenceExpander::invalidate(const QString& seriesKey) {
+    m_cache.remove(seriesKey);
+}
+
+void RecurrenceExpander::clear() {
+    m_cache.clear();
+}
+
+QList<CalendarEvent> RecurrenceExpander::expand(const CalendarEvent& master,
+                                                const QDateTime& start, const QDateTime& end,
+                                                const QList<CalendarEvent>& overrides) {
+    const qint64 startMs = start.toMSecsSinceEpoch();
+    const qint64 endMs = end.toMSecsSinceEpoch();
+    const QString key = seriesKeyOf(master);
+    const size_t signature = signatureOf(master, overrides);
+    
+    SeriesCache& cache = m_cache[key];
+    if (cache.signature != signature) {
+        cache.signature = signature;
+        cache.windows.clear();
+    }
+    
+    // 已快取的範圍涵蓋查詢範圍時直接篩選
+    for (const CachedWindow& window : cache.windows) {
+        if (window.start <= startMs && endMs <= window.end) {
+            QList<CalendarEvent> result;
+            for (const auto& occurrence : window.occurrences) {
+                if (occurrence.startTime.toMSecsSinceEpoch() < endMs &&
+                    occurrence.endTime.toMSecsSinceEpoch() > startMs) {
+                    result.append(occurrence);
+                }
+            }
+            return result;
+        }
+    }
+    
+    QList<CalendarEvent> occurrences = generate(master, start, end, overrides);
+    
+    if (cache.windows.size() >= kMaxCachedWindows) {
+        cache.windows.removeFirst();
+    }
+    cache.windows.append({startMs, endMs, occurrences});
+    
+    return occurrences;
+}
+
+QList<CalendarEvent> RecurrenceExpander::generate(const CalendarEvent& master,
+                                                  const QDateTime& start, const QDateTime& end,
+                                                  const QList<CalendarEvent>& overrides) const {
+    QList<CalendarEvent> result;
+    if (!master.startTime.isValid()) {
+        return result;
+    }
+    
+    const QTimeZone zone = master.startTime.timeZone();
+    const RecurrenceRule rule = RecurrenceRule::parse(master.recurrenceRule, zone);
+    if (!rule.isValid()) {
+        return result;
+    }
+    
+    const qint64 durationMs = master.endTime.isValid()
+        ? master.startTime.msecsTo(master.endTime) : 0;
+    const qint64 startMs = start.toMSecsSinceEpoch();
+    const qint64 endMs = end.toMSecsSinceEpoch();
+    
+    QHash<qint64, const CalendarEvent*> overrideByOriginal;
+    for (const auto& item : overrides) {
+        if (item.originalStartTime.isValid()) {
+            overrideByOriginal.insert(item.originalStartTime.toMSecsSinceEpoch(), &item);
+        }
+    }
+    
+    QSet<qint64> emitted;
+    auto emitOccurrence = [&](const QDateTime& occurrenceStart) {
+        const qint64 occurrenceMs = occurrenceStart.toMSecsSinceEpoch();
+        if (emitted.contains(occurrenceMs) || rule.exDates.contains(occurrenceMs) ||
+            rule.exDays.contains(occurrenceStart.date())) {
+            return;
+        }
+        emitted.insert(occurrenceMs);
+        
+        // 例外實例取代原本的發生時間
+        if (const CalendarEvent* item = overrideByOriginal.value(occurrenceMs, nullptr)) {
+            if (!item->isCancelled && item->startTime.toMSecsSinceEpoch() < endMs &&
+                item->endTime.toMSecsSinceEpoch() > startMs) {
+                result.append(*item);
+            }
+            return;
+        }
+        
+        if (occurrenceMs >= endMs || occurrenceMs + std::max<qint64>(durationMs, 1) <= startMs) {
+            return;
+        }
+        
+        CalendarEvent occurrence = master;
+        occurrence.id = occurrenceId(master, occurrenceStart);
+        occurrence.seriesMasterId = master.id;
+        occurrence.originalStartTime = occurrenceStart;
+        occurrence.startTime = occurrenceStart;
+        occurrence.endTime = occurrenceStart.addMSecs(durationMs);
+        occurrence.recurrenceRule.clear();
+        result.append(occurrence);
+    };
+    
+    if (rule.frequency != RecurrenceRule::Frequency::None) {
+        const QDate dtstart = master.startTime.date();
+        const QTime timeOfDay = master.startTime.time();
+        const QDate lastDate = end.toTimeZone(zone).date().addDays(1);
+        const qint64 untilMs = rule.until.isValid() ? rule.until.toMSecsSinceEpoch()
+                                                    : std::numeric_limits<qint64>::max();
+        
+        int produced = 0;
+        bool done = false;
+        const int firstPeriod = firstPeriodNear(rule, dtstart,
+                                                start.addMSecs(-durationMs).toTimeZone(zone).date());
+        
+        for (int period = firstPeriod; !done && period < firstPeriod + kMaxPeriods; ++period) {
+            if (periodStart(rule, dtstart, period) > lastDate) {
+                break;
+            }
+            
+            for (const QDate& date : candidatesForPeriod(rule, dtstart, period)) {
+                const QDateTime occurrenceStart(date, timeOfDay, zone);
+                const qint64 occurrenceMs = occurrenceStart.toMSecsSinceEpoch();
+                if (occurrenceMs < master.startTime.toMSecsSinceEpoch()) {
+                    continue;
+                }
+                if (occurrenceMs > untilMs || occurrenceMs >= endMs ||
+                    (rule.count > 0 && produced >= rule.count)) {
+                    done = true;
+                    break;
+                }
+                
+                ++produced;
+                emitOccurrence(occurrenceStart);
+            }
+        }
+    }
+    
+    for (const QDateTime& rdate : rule.rDates) {
+        emitOccurrence(rdate);
+    }
+    
+    // 被移入查詢範圍、但原本時間不在範圍內的例外實例
+    for (const auto& item : overrides) {
+        const qint64 originalMs = item.originalStartTime.toMSecsSinceEpoch();
+        if (item.isCancelled || emitted.contains(originalMs)) {
+            continue;
+        }
+        if (item.startTime.toMSecsSinceEpoch() < endMs && item.endTime.toMSecsSinceEpoch() > startMs) {
+            result.append(item);
+        }
+    }
+    
+    std::sort(result.begin(), result.end(), [](const CalendarEvent& a, const CalendarEvent& b) {
+        return a.startTime < b.startTime;
+    });
+    
+    return result;
+}
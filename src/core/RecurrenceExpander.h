@@ -0,0 +1,82 @@
+#pragma once
+
+#include <QDateTime>
+#include <QTimeZone>
+#include <QList>
+#include <QHash>
+#include <QSet>
+#include "CalendarEvent.h"
+
+// 重複規則 - 解析 RFC 5545 的 RRULE/EXDATE/RDATE 行
+struct RecurrenceRule {
+    enum class Frequency {
+        None,
+        Daily,
+        Weekly,
+        Monthly,
+        Yearly
+    };
+    
+    // BYDAY 項目，ordinal 為 0 表示該週期內所有該星期幾
+    struct WeekdayNum {
+        int ordinal = 0;
+        int weekday = 1;  // 1 = 星期一 ... 7 = 星期日
+    };
+    
+    Frequency frequency = Frequency::None;
+    int interval = 1;
+    int count = 0;            // 0 表示不限次數
+    QDateTime until;          // 無效表示不限結束時間
+    QList<WeekdayNum> byDay;
+    QList<int> byMonthDay;    // 負數表示從月底倒數
+    QList<int> byMonth;
+    QList<int> bySetPos;      // 週期內候選日期的第幾個，負數表示從最後倒數
+    int weekStart = 1;
+    
+    QSet<qint64> exDates;     // 排除的發生時間 (epoch 毫秒)
+    QSet<QDate> exDays;       // 以日期排除（VALUE=DATE）
+    QList<QDateTime> rDates;  // 額外的發生時間
+    
+    bool isValid() const { return frequency != Frequency::None || !rDates.isEmpty(); }
+    
+    // zone 為 DTSTART 的時區，用於沒有 TZID 的本地時間
+    static RecurrenceRule parse(const QString& text, const QTimeZone& zone);
+};
+
+// 重複事件展開引擎 - 只產生查詢範圍內的實例，並依系列快取已展開的範圍
+class RecurrenceExpander {
+public:
+    // 展開系列主事件在 [start, end) 內的實例；overrides 為同系列的例外實例
+    // （以 originalStartTime 對應，isCancelled 表示該次已取消）
+    QList<CalendarEvent> expand(const CalendarEvent& master,
+                                const QDateTime& start, const QDateTime& end,
+                                const QList<CalendarEvent>& overrides = {});
+    
+    void invalidate(const QString& seriesKey);
+    void clear();
+    
+    // 實例 id，格式與 Google 的 singleEvents 實例一致
+    static QString occurrenceId(const CalendarEvent& master, const QDateTime& occurrenceStart);
+    static QString seriesKeyOf(const CalendarEvent& master);
+    
+private:
+    struct CachedWindow {
+        qint64 start;
+        qint64 end;
+        QList<CalendarEvent> occurrences;
+    };
+    
+    struct SeriesCache {
+        size_t signature = 0;
+        QList<CachedWindow> windows;
+    };
+    
+    static constexpr int kMaxCachedWindows = 4;
+    
+    QList<CalendarEvent> generate(const CalendarEvent& master,
+                                  const QDateTime& start, const QDateTime& end,
+                                  const QList<CalendarEvent>& overrides) const;
+    static size_t signatureOf(const CalendarEvent& master, const QList<CalendarEvent>& overrides);
+    
+    QHash<QString, SeriesCache> m_cache;
+};
@@ -0,0 +1,53 @@
+#include "StringPool.h"
+
+namespace {
+
+// QString 堆積資料的估計大小：表頭加上 UTF-16 內容
+qint64 stringHeapBytes(const QString& text) {
+    return text.isEmpty() ? 0 : 16 + (text.capacity() + 1) * qint64(sizeof(QChar));
+}
+
+} // namespace
+
+StringPool::StringPool() {
+    m_strings.append(QString());
+}
+
+quint32 StringPool::intern(const QString& text) {
+    if (text.isEmpty()) {
+        return 0;
+    }
+    
+    auto it = m_ids.constFind(text);
+    if (it != m_ids.constEnd()) {
+        return it.value();
+    }
+    
+    const quint32 id = quint32(m_strings.size());
+    m_strings.append(text);
+    m_ids.insert(text, id);
+    return id;
+}
+
+qint64 StringPool::find(const QString& text) const {
+    if (text.isEmpty()) {
+        return 0;
+    }
+    return m_ids.contains(text) ? qint64(m_ids.value(text)) : -1;
+}
+
+qint64 StringPool::bytesUsed() const {
+    // 字串內容在陣列與雜湊表之間共用，只計算一次
+    qint64 bytes = m_strings.capacity() * qint64(sizeof(QString));
+    bytes += m_ids.capacity() * qint64(sizeof(QString) + sizeof(quint32) + sizeof(size_t));
+    for (const QString& text : m_strings) {
+        bytes += stringHeapBytes(text);
+    }
+    return bytes;
+}
+
+void StringPool::clear() {
+    m_strings.clear();
+    m_ids.clear();
+    m_strings.append(QString());
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+
+// 字串池 - 將重複出現的字串（擁有者、地點、參與者 email）以 32 位元 id 表示。
+// id 0 固定代表空字串；池只增不減，於 clear() 時一併釋放。
+class StringPool {
+public:
+    StringPool();
+    
+    quint32 intern(const QString& text);
+    const QString& value(quint32 id) const { return m_strings[id]; }
+    
+    // 已存在時回傳 id，否則回傳 -1（查詢不會新增字串）
+    qint64 find(const QString& text) const;
+    
+    int size() const { return m_strings.size(); }
+    qint64 bytesUsed() const;
+    void clear();
+    
+private:
+    QVector<QString> m_strings;
+    QHash<QString, quint32> m_ids;
+};
@@ -0,0 +1,139 @@
+#include "TrigramIndex.h"
+#include <algorithm>
+
+namespace {
+
+constexpr int kMaxGram = 3;
+
+} // namespace
+
+void TrigramIndex::clear() {
+    m_postings.clear();
+}
+
+quint64 TrigramIndex::gramKey(const char32_t* codePoints, int length) {
+    // 每個碼位 21 位元；未使用的位置為 0，因此不同長度的 gram 不會衝突
+    quint64 key = 0;
+    for (int i = 0; i < kMaxGram; ++i) {
+        key = (key << 21) | (i < length ? (codePoints[i] & 0x1FFFFF) : 0);
+    }
+    return key;
+}
+
+QVector<quint64> TrigramIndex::gramsOf(const QStringList& fields) {
+    QVector<quint64> grams;
+    
+    // 每個欄位分開切割，避免產生跨欄位的 gram
+    for (const QString& field : fields) {
+        if (field.isEmpty()) {
+            continue;
+        }
+        const std::u32string text = fold(field).toStdU32String();
+        const int length = int(text.size());
+        for (int i = 0; i < length; ++i) {
+            if (text[i] == 0) {
+                continue;
+            }
+            for (int n = 1; n <= kMaxGram && i + n <= length; ++n) {
+                grams.append(gramKey(text.data() + i, n));
+            }
+        }
+    }
+    
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+    return grams;
+}
+
+void TrigramIndex::insert(int slot, const QStringList& fields) {
+    for (quint64 gram : gramsOf(fields)) {
+        QVector<int>& postings = m_postings[gram];
+        // slot 多半遞增配置，直接附加；重用的 slot 才需要插入
+        if (postings.isEmpty() || postings.last() < slot) {
+            postings.append(slot);
+        } else {
+            auto it = std::lower_bound(postings.begin(), postings.end(), slot);
+            if (it == postings.end() || *it != slot) {
+                postings.insert(it, slot);
+            }
+        }
+    }
+}
+
+void TrigramIndex::remove(int slot, const QStringList& fields) {
+    for (quint64 gram : gramsOf(fields)) {
+        auto found = m_postings.find(gram);
+        if (found == m_postings.end()) {
+            continue;
+        }
+        QVector<int>& postings = found.value();
+        auto it = std::lower_bound(postings.begin(), postings.end(), slot);
+        if (it != postings.end() && *it == slot) {
+            postings.erase(it);
+        }
+        if (postings.isEmpty()) {
+            m_postings.erase(found);
+        }
+    }
+}
+
+QVector<int> TrigramIndex::intersect(const QVector<int>& a, const QVector<int>& b) {
+    // a 為較短的清單；對 b 以倍增搜尋前進，長度懸殊時接近 O(|a| log |b|)
+    QVector<int> result;
+    auto from = b.cbegin();
+    for (int slot : a) {
+        int step = 1;
+        auto probe = from;
+        while (probe != b.cend() && *probe < slot) {
+            from = probe;
+            probe = (b.cend() - probe > step) ? probe + step : b.cend();
+            step *= 2;
+        }
+        from = std::lower_bound(from, probe, slot);
+        if (from == b.cend()) {
+            break;
+        }
+        if (*from == slot) {
+            result.append(slot);
+        }
+    }
+    return result;
+}
+
+QVector<int> TrigramIndex::candidates(const QString& query, bool* exact) const {
+    const std::u32string text = fold(query).toStdU32String();
+    const int length = int(text.size());
+    
+    if (exact) {
+        *exact = length <= kMaxGram;
+    }
+    if (length == 0) {
+        return {};
+    }
+    
+    // 短查詢本身就是一個 gram
+    if (length <= kMaxGram) {
+        return m_postings.value(gramKey(text.data(), length));
+    }
+    
+    QVector<const QVector<int>*> lists;
+    for (int i = 0; i + kMaxGram <= length; ++i) {
+        auto it = m_postings.constFind(gramKey(text.data() + i, kMaxGram));
+        if (it == m_postings.constEnd()) {
+            return {};
+        }
+        lists.append(&it.value());
+    }
+    
+    // 由最短的清單開始交集，候選數量最快縮小
+    std::sort(lists.begin(), lists.end(), [](const QVector<int>* a, const QVector<int>* b) {
+        return a->size() != b->size() ? a->size() < b->size() : a < b;
+    });
+    lists.erase(std::unique(lists.begin(), lists.end()), lists.end());
+    
+    QVector<int> result = *lists.first();
+    for (int i = 1; i < lists.size() && !result.isEmpty(); ++i) {
+        result = intersect(result, *lists[i]);
+    }
+    return result;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+
+// n-gram 倒排索引 - 支援任意子字串搜尋。
+// 文字先做 case folding 再以 UCS-4 碼位切出 1、2、3-gram（中文常只輸入一兩個字）；
+// 每個 gram 對應遞增排序的 slot 清單。三個碼位以內的查詢直接對應單一 gram，
+// 較長的查詢以所有 trigram 的交集作為候選，需由呼叫端再驗證。
+class TrigramIndex {
+public:
+    void clear();
+    void insert(int slot, const QStringList& fields);
+    void remove(int slot, const QStringList& fields);
+    
+    // 候選 slot，遞增排序；exact 為 true 時結果即為答案，不需再驗證
+    QVector<int> candidates(const QString& query, bool* exact = nullptr) const;
+    
+    int gramCount() const { return m_postings.size(); }
+    
+    static QString fold(const QString& text) { return text.toCaseFolded(); }
+    
+private:
+    static quint64 gramKey(const char32_t* codePoints, int length);
+    static QVector<quint64> gramsOf(const QStringList& fields);
+    static QVector<int> intersect(const QVector<int>& a, const QVector<int>& b);
+    
+    QHash<quint64, QVector<int>> m_postings;
+};
@@ -1,7 +1,30 @@
 #include "DatabaseManager.h"
+#include "DatabaseWriter.h"
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QRegularExpression>
+#include <QTimeZone>
+#include <QVersionNumber>
+
+namespace {
+
+const char* const kUpsertEventSql = R"(
+        INSERT OR REPLACE INTO events 
+        (id, title, description, start_time, end_time, location, platform, owner_id, is_all_day,
+         recurrence_rule, series_master_id, original_start_time, is_cancelled, ical_uid, time_zone)
+        VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+    )";
+
+const char* const kUpsertTaskSql = R"(
+        INSERT OR REPLACE INTO tasks 
+        (id, title, description, due_date, platform, owner_id, is_completed, priority)
+        VALUES (?, ?, ?, ?, ?, ?, ?, ?)
+    )";
+
+} // namespace
 
 DatabaseManager::DatabaseManager(QObject* parent)
     : QObject(parent)
@@ -9,12 +32,15 @@ DatabaseManager::DatabaseManager(QObject* parent)
 }
 
 DatabaseManager::~DatabaseManager() {
+    stopAsyncWrites();
+    
     if (m_db.isOpen()) {
         m_db.close();
     }
 }
 
 bool DatabaseManager::initialize(const QString& dbPath) {
+    m_dbPath = dbPath;
     m_db = QSqlDatabase::addDatabase("QSQLITE");
     m_db.setDatabaseName(dbPath);
     
@@ -25,7 +51,103 @@ bool DatabaseManager::initialize(const QString& dbPath) {
     
     qDebug() << "資料庫已開啟:" << dbPath;
     
-    return createTables();
+    configureConnection(m_db);
+    
+    if (!createTables() || !migrateSchema() || !createIndexes()) {
+        return false;
+    }
+    
+    // 全文檢索索引失敗時不影響其他功能，搜尋會退回線性掃描
+    m_ftsAvailable = createFullTextIndex();
+    return true;
+}
+
+bool DatabaseManager::configureConnection(QSqlDatabase& db) {
+    QSqlQuery query(db);
+    
+    // WAL 模式讓讀取連線不會被背景寫入阻擋
+    if (!query.exec("PRAGMA journal_mode=WAL") || !query.next() ||
+        query.value(0).toString().compare("wal", Qt::CaseInsensitive) != 0) {
+        qWarning() << "無法啟用 WAL 模式，沿用預設日誌模式";
+    }
+    query.finish();
+    
+    query.exec("PRAGMA synchronous=NORMAL");
+    query.exec("PRAGMA busy_timeout=5000");
+    
+    // INSERT OR REPLACE 取代舊列時需觸發刪除觸發器，全文索引才不會殘留舊內容
+    query.exec("PRAGMA recursive_triggers=ON");
+    return true;
+}
+
+bool DatabaseManager::enableAsyncWrites() {
+    if (m_writer) {
+        return true;
+    }
+    if (!m_db.isOpen() || m_dbPath == ":memory:") {
+        qWarning() << "非同步寫入需要已開啟的檔案資料庫";
+        return false;
+    }
+    
+    m_writerThread = new QThread(this);
+    m_writerThread->setObjectName("DatabaseWriter");
+    m_writer = new DatabaseWriter();
+    m_writer->moveToThread(m_writerThread);
+    
+    connect(m_writerThread, &QThread::finished, m_writer, &QObject::deleteLater);
+    connect(m_writer, &DatabaseWriter::flushed, this, &DatabaseManager::writesFlushed);
+    
+    m_writerThread->start();
+    
+    bool opened = false;
+    QMetaObject::invokeMethod(m_writer, "open", Qt::BlockingQueuedConnection,
+                              Q_RETURN_ARG(bool, opened), Q_ARG(QString, m_dbPath));
+    if (!opened) {
+        stopAsyncWrites();
+        return false;
+    }
+    
+    qDebug() << "已啟用背景寫入執行緒";
+    return true;
+}
+
+void DatabaseManager::stopAsyncWrites() {
+    if (!m_writerThread) {
+        return;
+    }
+    
+    // 寫完佇列中剩餘的資料再關閉連線
+    QMetaObject::invokeMethod(m_writer, "close", Qt::BlockingQueuedConnection);
+    m_writerThread->quit();
+    m_writerThread->wait();
+    m_writerThread->deleteLater();
+    
+    m_writerThread = nullptr;
+    m_writer = nullptr;
+}
+
+quint64 DatabaseManager::saveEventsAsync(const QList<CalendarEvent>& events) {
+    if (!m_writer) {
+        saveEvents(events);
+        return 0;
+    }
+    return m_writer->enqueueEvents(events);
+}
+
+quint64 DatabaseManager::saveTasksAsync(const QList<Task>& tasks) {
+    if (!m_writer) {
+        saveTasks(tasks);
+        return 0;
+    }
+    return m_writer->enqueueTasks(tasks);
+}
+
+quint64 DatabaseManager::deleteEventsAsync(const QStringList& eventIds) {
+    if (!m_writer) {
+        deleteRows(m_db, "events", eventIds);
+        return 0;
+    }
+    return m_writer->enqueueEventDeletes(eventIds);
 }
 
 bool DatabaseManager::createTables() {
@@ -72,36 +194,419 @@ bool DatabaseManager::createTables() {
         return false;
     }
     
+    // 建立增量同步狀態表
+    QString createSyncStateTable = R"(
+        CREATE TABLE IF NOT EXISTS sync_state (
+            platform INTEGER NOT NULL,
+            calendar_id TEXT NOT NULL,
+            scope TEXT,
+            sync_token TEXT,
+            updated_at DATETIME DEFAULT CURRENT_TIMESTAMP,
+            PRIMARY KEY (platform, calendar_id)
+        )
+    )";
+    
+    if (!query.exec(createSyncStateTable)) {
+        qCritical() << "建立 sync_state 表失敗:" << query.lastError().text();
+        return false;
+    }
+    
     qDebug() << "資料庫表已建立";
     return true;
 }
 
-bool DatabaseManager::saveEvent(const CalendarEvent& event) {
+bool DatabaseManager::createIndexes() {
     QSqlQuery query(m_db);
-    query.prepare(R"(
-        INSERT OR REPLACE INTO events 
-        (id, title, description, start_time, end_time, location, platform, owner_id, is_all_day)
-        VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)
-    )");
     
+    // 時間範圍查詢與平台/擁有者篩選使用的複合索引
+    const QStringList statements = {
+        "CREATE INDEX IF NOT EXISTS idx_events_time ON events (start_time, end_time)",
+        "CREATE INDEX IF NOT EXISTS idx_events_platform ON events (platform, start_time)",
+        "CREATE INDEX IF NOT EXISTS idx_events_owner ON events (owner_id, start_time)",
+        "CREATE INDEX IF NOT EXISTS idx_tasks_due ON tasks (due_date)"
+    };
+    
+    for (const QString& sql : statements) {
+        if (!query.exec(sql)) {
+            qCritical() << "建立索引失敗:" << query.lastError().text();
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+bool DatabaseManager::createFullTextIndex() {
+    QSqlQuery query(m_db);
+    
+    // trigram 斷詞需要 SQLite 3.34 以上；較舊的版本退回 unicode61，只用於拉丁文字查詢
+    query.exec("SELECT sqlite_version()");
+    const QVersionNumber version = query.next()
+        ? QVersionNumber::fromString(query.value(0).toString()) : QVersionNumber();
+    query.finish();
+    m_ftsTrigram = version >= QVersionNumber(3, 34);
+    
+    query.exec("SELECT sql FROM sqlite_master WHERE type = 'table' AND name = 'events_fts'");
+    bool existed = query.next();
+    const bool existedTrigram = existed && query.value(0).toString().contains("trigram");
+    query.finish();
+    
+    // 舊版以 unicode61 斷詞，連續的中文會被當成一個詞而無法以子字串搜尋；改用 trigram 重建
+    if (existed && existedTrigram != m_ftsTrigram) {
+        if (!query.exec("DROP TABLE events_fts")) {
+            qWarning() << "移除舊的全文檢索索引失敗:" << query.lastError().text();
+            return false;
+        }
+        existed = false;
+    }
+    
+    // 外部內容表：索引內容來自 events，以 rowid 對應
+    const QString createFtsTable = R"(
+        CREATE VIRTUAL TABLE IF NOT EXISTS events_fts USING fts5(
+            title, description, location,
+            content='events', content_rowid='rowid',
+            tokenize='%1'
+        )
+    )";
+    
+    if (!m_ftsTrigram) {
+        qWarning() << "SQLite" << version.toString() << "不支援 trigram 斷詞，全文檢索僅用於拉丁文字";
+    }
+    if (!query.exec(createFtsTable.arg(m_ftsTrigram ? "trigram" : "unicode61 remove_diacritics 2"))) {
+        qWarning() << "建立全文檢索索引失敗（SQLite 可能未啟用 FTS5）:" << query.lastError().text();
+        return false;
+    }
+    
+    const QStringList triggers = {
+        R"(CREATE TRIGGER IF NOT EXISTS events_fts_ai AFTER INSERT ON events BEGIN
+               INSERT INTO events_fts (rowid, title, description, location)
+               VALUES (new.rowid, new.title, new.description, new.location);
+           END)",
+        R"(CREATE TRIGGER IF NOT EXISTS events_fts_ad AFTER DELETE ON events BEGIN
+               INSERT INTO events_fts (events_fts, rowid, title, description, location)
+               VALUES ('delete', old.rowid, old.title, old.description, old.location);
+           END)",
+        R"(CREATE TRIGGER IF NOT EXISTS events_fts_au AFTER UPDATE ON events BEGIN
+               INSERT INTO events_fts (events_fts, rowid, title, description, location)
+               VALUES ('delete', old.rowid, old.title, old.description, old.location);
+               INSERT INTO events_fts (rowid, title, description, location)
+               VALUES (new.rowid, new.title, new.description, new.location);
+           END)"
+    };
+    
+    for (const QString& sql : triggers) {
+        if (!query.exec(sql)) {
+            qWarning() << "建立全文檢索觸發器失敗:" << query.lastError().text();
+            return false;
+        }
+    }
+    
+    // 首次建立時為既有事件建立索引
+    if (!existed && !query.exec("INSERT INTO events_fts (events_fts) VALUES ('rebuild')")) {
+        qWarning() << "重建全文檢索索引失敗:" << query.lastError().text();
+        return false;
+    }
+    
+    return true;
+}
+
+bool DatabaseManager::migrateSchema() {
+    QSqlQuery query(m_db);
+    if (!query.exec("PRAGMA user_version") || !query.next()) {
+        qCritical() << "讀取資料庫版本失敗:" << query.lastError().text();
+        return false;
+    }
+    const int version = query.value(0).toInt();
+    query.finish();
+    
+    if (version < 1 && !migrateToVersion1()) {
+        return false;
+    }
+    if (version < 2 && !migrateToVersion2()) {
+        return false;
+    }
+    if (version < 3 && !migrateToVersion3()) {
+        return false;
+    }
+    if (version < 4 && !migrateToVersion4()) {
+        return false;
+    }
+    
+    return true;
+}
+
+bool DatabaseManager::migrateToVersion1() {
+    QSqlQuery query(m_db);
+    
+    // 版本 1：事件時間統一以 UTC 儲存，讓字串比較等同時間比較；
+    // 任何一列轉換失敗都整批回復，避免 UTC 與本地時間混雜
+    if (!m_db.transaction()) {
+        qCritical() << "資料庫升級失敗，無法開始交易:" << m_db.lastError().text();
+        return false;
+    }
+    
+    QSqlQuery select("SELECT id, start_time, end_time FROM events", m_db);
+    QSqlQuery update(m_db);
+    update.prepare("UPDATE events SET start_time = ?, end_time = ? WHERE id = ?");
+    
+    while (select.next()) {
+        update.addBindValue(select.value(1).toDateTime().toUTC());
+        update.addBindValue(select.value(2).toDateTime().toUTC());
+        update.addBindValue(select.value(0).toString());
+        if (!update.exec()) {
+            qCritical() << "轉換事件時間失敗:" << update.lastError().text();
+            select.finish();
+            update.finish();
+            m_db.rollback();
+            return false;
+        }
+    }
+    select.finish();
+    update.finish();
+    
+    if (!query.exec("PRAGMA user_version = 1") || !m_db.commit()) {
+        qCritical() << "資料庫升級失敗:" << m_db.lastError().text();
+        m_db.rollback();
+        return false;
+    }
+    
+    qDebug() << "資料庫已升級至版本 1";
+    return true;
+}
+
+bool DatabaseManager::migrateToVersion2() {
+    QSqlQuery query(m_db);
+    
+    // 版本 2：保存重複規則與例外實例資訊，供本地展開重複事件
+    const QStringList statements = {
+        "ALTER TABLE events ADD COLUMN recurrence_rule TEXT DEFAULT ''",
+        "ALTER TABLE events ADD COLUMN series_master_id TEXT DEFAULT ''",
+        "ALTER TABLE events ADD COLUMN original_start_time DATETIME",
+        "ALTER TABLE events ADD COLUMN is_cancelled INTEGER DEFAULT 0",
+        "PRAGMA user_version = 2"
+    };
+    
+    if (!m_db.transaction()) {
+        qCritical() << "資料庫升級失敗，無法開始交易:" << m_db.lastError().text();
+        return false;
+    }
+    for (const QString& statement : statements) {
+        if (!query.exec(statement)) {
+            qCritical() << "資料庫升級失敗:" << query.lastError().text();
+            m_db.rollback();
+            return false;
+        }
+    }
+    
+    if (!m_db.commit()) {
+        qCritical() << "資料庫升級失敗:" << m_db.lastError().text();
+        m_db.rollback();
+        return false;
+    }
+    
+    qDebug() << "資料庫已升級至版本 2";
+    return true;
+}
+
+bool DatabaseManager::migrateToVersion3() {
+    QSqlQuery query(m_db);
+    
+    // 版本 3：保存 iCalendar UID，重新載入後仍能合併跨平台的重複會議
+    const QStringList statements = {
+        "ALTER TABLE events ADD COLUMN ical_uid TEXT DEFAULT ''",
+        "CREATE INDEX IF NOT EXISTS idx_events_ical_uid ON events(ical_uid)",
+        "PRAGMA user_version = 3"
+    };
+    
+    if (!m_db.transaction()) {
+        qCritical() << "資料庫升級失敗，無法開始交易:" << m_db.lastError().text();
+        return false;
+    }
+    for (const QString& statement : statements) {
+        if (!query.exec(statement)) {
+            qCritical() << "資料庫升級失敗:" << query.lastError().text();
+            m_db.rollback();
+            return false;
+        }
+    }
+    
+    if (!m_db.commit()) {
+        qCritical() << "資料庫升級失敗:" << m_db.lastError().text();
+        m_db.rollback();
+        return false;
+    }
+    
+    qDebug() << "資料庫已升級至版本 3";
+    return true;
+}
+
+bool DatabaseManager::migrateToVersion4() {
+    QSqlQuery query(m_db);
+    
+    // 版本 4：保存事件的 IANA 時區，重新載入後仍能依該時區展開重複事件（跨越日光節約時間）
+    const QStringList statements = {
+        "ALTER TABLE events ADD COLUMN time_zone TEXT DEFAULT ''",
+        "PRAGMA user_version = 4"
+    };
+    
+    if (!m_db.transaction()) {
+        qCritical() << "資料庫升級失敗，無法開始交易:" << m_db.lastError().text();
+        return false;
+    }
+    for (const QString& statement : statements) {
+        if (!query.exec(statement)) {
+            qCritical() << "資料庫升級失敗:" << query.lastError().text();
+            m_db.rollback();
+            return false;
+        }
+    }
+    
+    if (!m_db.commit()) {
+        qCritical() << "資料庫升級失敗:" << m_db.lastError().text();
+        m_db.rollback();
+        return false;
+    }
+    
+    qDebug() << "資料庫已升級至版本 4";
+    return true;
+}
+
+void DatabaseManager::bindEvent(QSqlQuery& query, const CalendarEvent& event) {
     query.addBindValue(event.id);
     query.addBindValue(event.title);
     query.addBindValue(event.description);
-    query.addBindValue(event.startTime);
-    query.addBindValue(event.endTime);
+    // 以 UTC 儲存，範圍查詢才能直接比較字串
+    query.addBindValue(event.startTime.toUTC());
+    query.addBindValue(event.endTime.toUTC());
     query.addBindValue(event.location);
     query.addBindValue(static_cast<int>(event.platform));
     query.addBindValue(event.ownerId);
     query.addBindValue(event.isAllDay ? 1 : 0);
+    query.addBindValue(event.recurrenceRule);
+    query.addBindValue(event.seriesMasterId);
+    query.addBindValue(event.originalStartTime.isValid() ? QVariant(event.originalStartTime.toUTC()) : QVariant());
+    query.addBindValue(event.isCancelled ? 1 : 0);
+    query.addBindValue(event.iCalUid);
+    // 固定時差無法表示日光節約時間，只保存具名時區
+    query.addBindValue(event.startTime.timeSpec() == Qt::TimeZone
+                       ? QString::fromUtf8(event.startTime.timeZone().id()) : QString());
+}
+
+bool DatabaseManager::saveEvent(const CalendarEvent& event) {
+    QElapsedTimer timer;
+    timer.start();
+    
+    QSqlQuery query(m_db);
+    query.prepare(kUpsertEventSql);
+    bindEvent(query, event);
     
     if (!query.exec()) {
         qWarning() << "儲存事件失敗:" << query.lastError().text();
         return false;
     }
     
+    m_singleRowStats.rows++;
+    m_singleRowStats.elapsedNs += timer.nsecsElapsed();
     return true;
 }
 
+void DatabaseManager::recordBatchTiming(BatchResult& result, const QElapsedTimer& timer, WriteStats* stats) {
+    const qint64 elapsedNs = timer.nsecsElapsed();
+    result.elapsedMs = elapsedNs / 1000000;
+    result.rowsPerSecond = elapsedNs > 0 ? result.succeeded * 1e9 / elapsedNs : 0.0;
+    
+    if (stats) {
+        stats->rows += result.succeeded;
+        stats->elapsedNs += elapsedNs;
+    }
+}
+
+DatabaseManager::BatchResult DatabaseManager::saveEvents(const QList<CalendarEvent>& events) {
+    return writeEvents(m_db, events, &m_batchStats);
+}
+
+DatabaseManager::BatchResult DatabaseManager::writeEvents(QSqlDatabase& db,
+                                                          const QList<CalendarEvent>& events,
+                                                          WriteStats* stats) {
+    BatchResult result;
+    if (events.isEmpty()) {
+        return result;
+    }
+    
+    QElapsedTimer timer;
+    timer.start();
+    
+    // 單一交易內重複使用同一個預備語句，整批只需一次 fsync
+    const bool inTransaction = db.transaction();
+    if (!inTransaction) {
+        qWarning() << "無法開始交易，改以自動提交寫入:" << db.lastError().text();
+    }
+    
+    QSqlQuery query(db);
+    query.prepare(kUpsertEventSql);
+    
+    for (const auto& event : events) {
+        bindEvent(query, event);
+        if (query.exec()) {
+            result.succeeded++;
+        } else {
+            qWarning() << "儲存事件失敗:" << event.id << query.lastError().text();
+            result.failedIds.append(event.id);
+        }
+    }
+    
+    query.finish();
+    if (inTransaction && !db.commit()) {
+        qWarning() << "提交交易失敗:" << db.lastError().text();
+        db.rollback();
+        for (const auto& event : events) {
+            result.failedIds.append(event.id);
+        }
+        result.failedIds.removeDuplicates();
+        result.succeeded = 0;
+    }
+    
+    recordBatchTiming(result, timer, stats);
+    return result;
+}
+
+DatabaseManager::BatchResult DatabaseManager::deleteRows(QSqlDatabase& db, const QString& table,
+                                                         const QStringList& ids) {
+    BatchResult result;
+    if (ids.isEmpty()) {
+        return result;
+    }
+    
+    QElapsedTimer timer;
+    timer.start();
+    
+    const bool inTransaction = db.transaction();
+    
+    QSqlQuery query(db);
+    query.prepare(QString("DELETE FROM %1 WHERE id = ?").arg(table));
+    
+    for (const QString& id : ids) {
+        query.addBindValue(id);
+        if (query.exec()) {
+            result.succeeded++;
+        } else {
+            qWarning() << "刪除失敗:" << table << id << query.lastError().text();
+            result.failedIds.append(id);
+        }
+    }
+    
+    query.finish();
+    if (inTransaction && !db.commit()) {
+        qWarning() << "提交交易失敗:" << db.lastError().text();
+        db.rollback();
+        result.failedIds = ids;
+        result.succeeded = 0;
+    }
+    
+    recordBatchTiming(result, timer, nullptr);
+    return result;
+}
+
 bool DatabaseManager::deleteEvent(const QString& eventId) {
     QSqlQuery query(m_db);
     query.prepare("DELETE FROM events WHERE id = ?");
@@ -115,38 +620,138 @@ bool DatabaseManager::deleteEvent(const QString& eventId) {
     return true;
 }
 
+CalendarEvent DatabaseManager::eventFromQuery(const QSqlQuery& query) {
+    CalendarEvent event;
+    event.id = query.value("id").toString();
+    event.title = query.value("title").toString();
+    event.description = query.value("description").toString();
+    event.startTime = query.value("start_time").toDateTime().toLocalTime();
+    event.endTime = query.value("end_time").toDateTime().toLocalTime();
+    event.location = query.value("location").toString();
+    event.platform = static_cast<Platform>(query.value("platform").toInt());
+    event.ownerId = query.value("owner_id").toString();
+    event.isAllDay = query.value("is_all_day").toInt() != 0;
+    event.recurrenceRule = query.value("recurrence_rule").toString();
+    event.seriesMasterId = query.value("series_master_id").toString();
+    const QVariant originalStart = query.value("original_start_time");
+    if (!originalStart.isNull()) {
+        event.originalStartTime = originalStart.toDateTime().toLocalTime();
+    }
+    event.isCancelled = query.value("is_cancelled").toInt() != 0;
+    event.iCalUid = query.value("ical_uid").toString();
+    
+    const QTimeZone zone(query.value("time_zone").toString().toUtf8());
+    if (zone.isValid()) {
+        event.startTime = event.startTime.toTimeZone(zone);
+        event.endTime = event.endTime.toTimeZone(zone);
+        if (event.originalStartTime.isValid()) {
+            event.originalStartTime = event.originalStartTime.toTimeZone(zone);
+        }
+    }
+    return event;
+}
+
 QList<CalendarEvent> DatabaseManager::loadEvents() {
     QList<CalendarEvent> events;
     
     QSqlQuery query("SELECT * FROM events ORDER BY start_time", m_db);
     
     while (query.next()) {
-        CalendarEvent event;
-        event.id = query.value("id").toString();
-        event.title = query.value("title").toString();
-        event.description = query.value("description").toString();
-        event.startTime = query.value("start_time").toDateTime();
-        event.endTime = query.value("end_time").toDateTime();
-        event.location = query.value("location").toString();
-        event.platform = static_cast<Platform>(query.value("platform").toInt());
-        event.ownerId = query.value("owner_id").toString();
-        event.isAllDay = query.value("is_all_day").toInt() != 0;
-        
-        events.append(event);
+        events.append(eventFromQuery(query));
     }
     
     qDebug() << "載入" << events.size() << "個事件";
     return events;
 }
 
-bool DatabaseManager::saveTask(const Task& task) {
+QList<CalendarEvent> DatabaseManager::loadEvents(const QDateTime& start, const QDateTime& end,
+                                                 std::optional<Platform> platform,
+                                                 const QString& ownerId) {
+    QList<CalendarEvent> events = queryEventRange(start, end, platform, ownerId, -1, nullptr);
+    qDebug() << "載入" << events.size() << "個事件 (" << start.toString(Qt::ISODate)
+             << "至" << end.toString(Qt::ISODate) << ")";
+    return events;
+}
+
+QList<CalendarEvent> DatabaseManager::loadEventsPage(const QDateTime& start, const QDateTime& end,
+                                                     int pageSize, EventCursor& cursor,
+                                                     std::optional<Platform> platform,
+                                                     const QString& ownerId) {
+    if (cursor.atEnd || pageSize <= 0) {
+        return {};
+    }
+    
+    QList<CalendarEvent> events = queryEventRange(start, end, platform, ownerId, pageSize,
+                                                  cursor.lastId.isEmpty() ? nullptr : &cursor);
+    
+    if (events.size() < pageSize) {
+        cursor.atEnd = true;
+    }
+    if (!events.isEmpty()) {
+        cursor.lastStart = events.last().startTime;
+        cursor.lastId = events.last().id;
+    }
+    
+    return events;
+}
+
+QList<CalendarEvent> DatabaseManager::queryEventRange(const QDateTime& start, const QDateTime& end,
+                                                      std::optional<Platform> platform,
+                                                      const QString& ownerId,
+                                                      int limit, const EventCursor* cursor) {
+    QList<CalendarEvent> events;
+    
+    // 與 [start, end) 重疊：start_time < end AND end_time > start；
+    // 重複系列主事件只要在範圍結束前開始就可能有實例落在範圍內
+    QString sql = "SELECT * FROM events WHERE start_time < ? AND (end_time > ? OR recurrence_rule <> '')";
+    if (platform) {
+        sql += " AND platform = ?";
+    }
+    if (!ownerId.isEmpty()) {
+        sql += " AND owner_id = ?";
+    }
+    if (cursor) {
+        sql += " AND (start_time > ? OR (start_time = ? AND id > ?))";
+    }
+    sql += " ORDER BY start_time, id";
+    if (limit > 0) {
+        sql += " LIMIT ?";
+    }
+    
     QSqlQuery query(m_db);
-    query.prepare(R"(
-        INSERT OR REPLACE INTO tasks 
-        (id, title, description, due_date, platform, owner_id, is_completed, priority)
-        VALUES (?, ?, ?, ?, ?, ?, ?, ?)
-    )");
+    query.setForwardOnly(true);
+    query.prepare(sql);
+    
+    query.addBindValue(end.toUTC());
+    query.addBindValue(start.toUTC());
+    if (platform) {
+        query.addBindValue(static_cast<int>(*platform));
+    }
+    if (!ownerId.isEmpty()) {
+        query.addBindValue(ownerId);
+    }
+    if (cursor) {
+        query.addBindValue(cursor->lastStart.toUTC());
+        query.addBindValue(cursor->lastStart.toUTC());
+        query.addBindValue(cursor->lastId);
+    }
+    if (limit > 0) {
+        query.addBindValue(limit);
+    }
     
+    if (!query.exec()) {
+        qWarning() << "查詢事件範圍失敗:" << query.lastError().text();
+        return events;
+    }
+    
+    while (query.next()) {
+        events.append(eventFromQuery(query));
+    }
+    
+    return events;
+}
+
+void DatabaseManager::bindTask(QSqlQuery& query, const Task& task) {
     query.addBindValue(task.id);
     query.addBindValue(task.title);
     query.addBindValue(task.description);
@@ -155,15 +760,215 @@ bool DatabaseManager::saveTask(const Task& task) {
     query.addBindValue(task.ownerId);
     query.addBindValue(task.isCompleted ? 1 : 0);
     query.addBindValue(task.priority);
+}
+
+QString DatabaseManager::buildFtsQuery(const QString& text, bool trigram) {
+    // 引號內視為片語，其餘每個詞做前綴比對；詞之間為 AND。
+    // trigram 斷詞下每個詞都是子字串比對，但少於 3 個字元的詞無法比對，回傳空字串；
+    // unicode61 斷詞無法切開連續的中日韓文字，含有這類文字時同樣回傳空字串
+    if (!trigram) {
+        for (const QChar ch : text) {
+            const QChar::Script script = ch.script();
+            if (script == QChar::Script_Han || script == QChar::Script_Hiragana ||
+                script == QChar::Script_Katakana || script == QChar::Script_Hangul) {
+                return QString();
+            }
+        }
+    }
+    
+    QStringList terms;
+    const QStringList segments = text.split('"');
+    
+    for (int i = 0; i < segments.size(); ++i) {
+        const QString segment = segments[i].trimmed();
+        if (segment.isEmpty()) {
+            continue;
+        }
+        
+        const bool isPhrase = (i % 2 == 1) && (i < segments.size() - 1);
+        const QStringList words = isPhrase
+            ? QStringList{segment}
+            : segment.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
+        for (const QString& word : words) {
+            if (trigram && word.size() < 3) {
+                return QString();
+            }
+            const QString quoted = QString("\"%1\"").arg(QString(word).replace('"', "\"\""));
+            terms.append(trigram || isPhrase ? quoted : quoted + '*');
+        }
+    }
+    
+    return terms.join(' ');
+}
+
+QStringList DatabaseManager::searchEventIds(const QString& text, int limit) {
+    QStringList ids;
+    
+    const QString match = buildFtsQuery(text, m_ftsTrigram);
+    if (!m_ftsAvailable || match.isEmpty()) {
+        return ids;
+    }
+    
+    // bm25 權重：標題 > 地點 > 描述
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    query.prepare(R"(
+        SELECT events.id FROM events_fts
+        JOIN events ON events.rowid = events_fts.rowid
+        WHERE events_fts MATCH ?
+        ORDER BY bm25(events_fts, 10.0, 1.0, 5.0)
+        LIMIT ?
+    )");
+    query.addBindValue(match);
+    query.addBindValue(limit);
+    
+    if (!query.exec()) {
+        qWarning() << "全文檢索失敗:" << query.lastError().text();
+        return ids;
+    }
+    
+    while (query.next()) {
+        ids.append(query.value(0).toString());
+    }
+    
+    return ids;
+}
+
+QList<CalendarEvent> DatabaseManager::searchEvents(const QString& text, int limit) {
+    QList<CalendarEvent> events;
+    
+    const QString match = buildFtsQuery(text, m_ftsTrigram);
+    if (!m_ftsAvailable || match.isEmpty()) {
+        return events;
+    }
+    
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    query.prepare(R"(
+        SELECT events.* FROM events_fts
+        JOIN events ON events.rowid = events_fts.rowid
+        WHERE events_fts MATCH ?
+        ORDER BY bm25(events_fts, 10.0, 1.0, 5.0)
+        LIMIT ?
+    )");
+    query.addBindValue(match);
+    query.addBindValue(limit);
+    
+    if (!query.exec()) {
+        qWarning() << "全文檢索失敗:" << query.lastError().text();
+        return events;
+    }
+    
+    while (query.next()) {
+        events.append(eventFromQuery(query));
+    }
+    
+    return events;
+}
+
+QString DatabaseManager::loadSyncState(Platform platform, const QString& calendarId, const QString& scope) {
+    QSqlQuery query(m_db);
+    query.prepare("SELECT scope, sync_token FROM sync_state WHERE platform = ? AND calendar_id = ?");
+    query.addBindValue(static_cast<int>(platform));
+    query.addBindValue(calendarId);
+    
+    if (!query.exec() || !query.next()) {
+        return QString();
+    }
+    
+    if (query.value(0).toString() != scope) {
+        return QString();
+    }
+    
+    return query.value(1).toString();
+}
+
+bool DatabaseManager::saveSyncState(Platform platform, const QString& calendarId,
+                                    const QString& scope, const QString& syncState) {
+    QSqlQuery query(m_db);
+    query.prepare(R"(
+        INSERT OR REPLACE INTO sync_state (platform, calendar_id, scope, sync_token, updated_at)
+        VALUES (?, ?, ?, ?, CURRENT_TIMESTAMP)
+    )");
+    query.addBindValue(static_cast<int>(platform));
+    query.addBindValue(calendarId);
+    query.addBindValue(scope);
+    query.addBindValue(syncState);
+    
+    if (!query.exec()) {
+        qWarning() << "儲存同步狀態失敗:" << query.lastError().text();
+        return false;
+    }
+    
+    return true;
+}
+
+bool DatabaseManager::saveTask(const Task& task) {
+    QElapsedTimer timer;
+    timer.start();
+    
+    QSqlQuery query(m_db);
+    query.prepare(kUpsertTaskSql);
+    bindTask(query, task);
     
     if (!query.exec()) {
         qWarning() << "儲存任務失敗:" << query.lastError().text();
         return false;
     }
     
+    m_singleRowStats.rows++;
+    m_singleRowStats.elapsedNs += timer.nsecsElapsed();
     return true;
 }
 
+DatabaseManager::BatchResult DatabaseManager::saveTasks(const QList<Task>& tasks) {
+    return writeTasks(m_db, tasks, &m_batchStats);
+}
+
+DatabaseManager::BatchResult DatabaseManager::writeTasks(QSqlDatabase& db,
+                                                         const QList<Task>& tasks,
+                                                         WriteStats* stats) {
+    BatchResult result;
+    if (tasks.isEmpty()) {
+        return result;
+    }
+    
+    QElapsedTimer timer;
+    timer.start();
+    
+    const bool inTransaction = db.transaction();
+    if (!inTransaction) {
+        qWarning() << "無法開始交易，改以自動提交寫入:" << db.lastError().text();
+    }
+    
+    QSqlQuery query(db);
+    query.prepare(kUpsertTaskSql);
+    
+    for (const auto& task : tasks) {
+        bindTask(query, task);
+        if (query.exec()) {
+            result.succeeded++;
+        } else {
+            qWarning() << "儲存任務失敗:" << task.id << query.lastError().text();
+            result.failedIds.append(task.id);
+        }
+    }
+    
+    query.finish();
+    if (inTransaction && !db.commit()) {
+        qWarning() << "提交交易失敗:" << db.lastError().text();
+        db.rollback();
+        for (const auto& task : tasks) {
+            result.failedIds.append(task.id);
+        }
+        result.failedIds.removeDuplicates();
+        result.succeeded = 0;
+    }
+    
+    recordBatchTiming(result, timer, stats);
+    return result;
+}
+
 bool DatabaseManager::deleteTask(const QString& taskId) {
     QSqlQuery query(m_db);
     query.prepare("DELETE FROM tasks WHERE id = ?");
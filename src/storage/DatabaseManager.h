@@ -2,14 +2,46 @@
 
 #include <QObject>
 #include <QSqlDatabase>
+#include <QElapsedTimer>
 #include <QList>
+#include <QStringList>
+#include <optional>
 #include "core/CalendarEvent.h"
 
+class QSqlQuery;
+class QThread;
+class DatabaseWriter;
+
 // 資料庫管理器 - 本地儲存
 class DatabaseManager : public QObject {
     Q_OBJECT
     
 public:
+    // 批次寫入結果 - 單列失敗不會中斷整批
+    struct BatchResult {
+        int succeeded = 0;
+        QStringList failedIds;
+        qint64 elapsedMs = 0;
+        double rowsPerSecond = 0.0;
+    };
+    
+    // 寫入吞吐量統計，用於比較逐筆與批次寫入
+    struct WriteStats {
+        qint64 rows = 0;
+        qint64 elapsedNs = 0;
+        
+        double rowsPerSecond() const {
+            return elapsedNs > 0 ? rows * 1e9 / elapsedNs : 0.0;
+        }
+    };
+    
+    // 鍵集分頁游標 - 記錄上一頁最後一列的 (start_time, id)
+    struct EventCursor {
+        QDateTime lastStart;
+        QString lastId;
+        bool atEnd = false;
+    };
+    
     explicit DatabaseManager(QObject* parent = nullptr);
     ~DatabaseManager() override;
     
@@ -18,16 +50,98 @@ public:
     
     // 事件操作
     bool saveEvent(const CalendarEvent& event);
+    BatchResult saveEvents(const QList<CalendarEvent>& events);
     bool deleteEvent(const QString& eventId);
     QList<CalendarEvent> loadEvents();
     
+    // 載入與 [start, end) 重疊的事件，可依平台與擁有者篩選（使用索引）
+    QList<CalendarEvent> loadEvents(const QDateTime& start, const QDateTime& end,
+                                    std::optional<Platform> platform = std::nullopt,
+                                    const QString& ownerId = QString());
+    
+    // 鍵集分頁載入，每次呼叫回傳下一頁並更新游標
+    QList<CalendarEvent> loadEventsPage(const QDateTime& start, const QDateTime& end,
+                                        int pageSize, EventCursor& cursor,
+                                        std::optional<Platform> platform = std::nullopt,
+                                        const QString& ownerId = QString());
+    
+    // 全文檢索（FTS5），依相關度排序；支援 "片語" 查詢。以 trigram 斷詞時每個詞都是子字串比對
+    // （中文亦可），但每個詞至少 3 個字元；canSearchFullText 為 false 的查詢應改用 n-gram 索引
+    bool isFullTextSearchAvailable() const { return m_ftsAvailable; }
+    bool canSearchFullText(const QString& text) const {
+        return m_ftsAvailable && !buildFtsQuery(text, m_ftsTrigram).isEmpty();
+    }
+    QStringList searchEventIds(const QString& text, int limit = 200);
+    QList<CalendarEvent> searchEvents(const QString& text, int limit = 200);
+    static QString buildFtsQuery(const QString& text, bool trigram = true);
+    
+    // 增量同步狀態（Google syncToken / Graph deltaLink），依平台與行事曆保存；
+    // scope 記錄建立狀態時的同步範圍，範圍不同時視為沒有狀態
+    QString loadSyncState(Platform platform, const QString& calendarId, const QString& scope);
+    bool saveSyncState(Platform platform, const QString& calendarId,
+                       const QString& scope, const QString& syncState);
+    
     // 任務操作
     bool saveTask(const Task& task);
+    BatchResult saveTasks(const QList<Task>& tasks);
     bool deleteTask(const QString& taskId);
     QList<Task> loadTasks();
     
+    // 吞吐量統計
+    WriteStats singleRowStats() const { return m_singleRowStats; }
+    WriteStats batchStats() const { return m_batchStats; }
+    
+    // 非同步儲存模式：背景執行緒以獨立的 WAL 連線寫入，
+    // 本物件的連線僅負責讀取。回傳的票號可與 writesFlushed 比對。
+    bool enableAsyncWrites();
+    bool isAsyncWritesEnabled() const { return m_writer != nullptr; }
+    quint64 saveEventsAsync(const QList<CalendarEvent>& events);
+    quint64 saveTasksAsync(const QList<Task>& tasks);
+    quint64 deleteEventsAsync(const QStringList& eventIds);
+    
+    // 供背景寫入執行緒共用的批次寫入實作
+    static BatchResult writeEvents(QSqlDatabase& db, const QList<CalendarEvent>& events,
+                                   WriteStats* stats = nullptr);
+    static BatchResult writeTasks(QSqlDatabase& db, const QList<Task>& tasks,
+                                  WriteStats* stats = nullptr);
+    static BatchResult deleteRows(QSqlDatabase& db, const QString& table, const QStringList& ids);
+    static bool configureConnection(QSqlDatabase& db);
+    
+signals:
+    // 票號 <= upToTicket 的非同步寫入皆已提交
+    void writesFlushed(quint64 upToTicket, const DatabaseManager::BatchResult& result);
+    
 private:
     QSqlDatabase m_db;
+    QString m_dbPath;
+    WriteStats m_singleRowStats;
+    WriteStats m_batchStats;
+    bool m_ftsAvailable = false;
+    bool m_ftsTrigram = false;
+    
+    QThread* m_writerThread = nullptr;
+    DatabaseWriter* m_writer = nullptr;
+    
+    void stopAsyncWrites();
     
     bool createTables();
+    bool createIndexes();
+    bool migrateSchema();
+    bool migrateToVersion1();
+    bool migrateToVersion2();
+    bool migrateToVersion3();
+    bool migrateToVersion4();
+    bool createFullTextIndex();
+    
+    QList<CalendarEvent> queryEventRange(const QDateTime& start, const QDateTime& end,
+                                         std::optional<Platform> platform,
+                                         const QString& ownerId,
+                                         int limit, const EventCursor* cursor);
+    
+    static CalendarEvent eventFromQuery(const QSqlQuery& query);
+    
+    static void bindEvent(QSqlQuery& query, const CalendarEvent& event);
+    static void bindTask(QSqlQuery& query, const Task& task);
+    // 批次寫入的耗時與吞吐量記入 BatchResult，並累計到 stats（可為空）
+    static void recordBatchTiming(BatchResult& result, const QElapsedTimer& timer, WriteStats* stats);
 };
@@ -0,0 +1,119 @@
+#include "DatabaseWriter.h"
+#include <QSqlError>
+#include <QMutexLocker>
+#include <QDebug>
+
+DatabaseWriter::DatabaseWriter(QObject* parent)
+    : QObject(parent)
+    , m_connectionName("calendar_writer")
+{
+}
+
+DatabaseWriter::~DatabaseWriter() {
+    close();
+}
+
+bool DatabaseWriter::open(const QString& dbPath) {
+    // 連線必須在使用它的執行緒中建立
+    m_db = QSqlDatabase::addDatabase("QSQLITE", m_connectionName);
+    m_db.setDatabaseName(dbPath);
+    
+    if (!m_db.open()) {
+        qCritical() << "背景寫入器無法開啟資料庫:" << m_db.lastError().text();
+        return false;
+    }
+    
+    DatabaseManager::configureConnection(m_db);
+    return true;
+}
+
+void DatabaseWriter::close() {
+    if (!m_db.isValid()) {
+        return;
+    }
+    
+    flush();
+    
+    m_db.close();
+    m_db = QSqlDatabase();
+    QSqlDatabase::removeDatabase(m_connectionName);
+}
+
+quint64 DatabaseWriter::enqueueEvents(const QList<CalendarEvent>& events) {
+    QMutexLocker locker(&m_mutex);
+    for (const auto& event : events) {
+        m_pendingEventDeletes.remove(event.id);
+        m_pendingEvents.insert(event.id, event);
+    }
+    return scheduleFlushLocked();
+}
+
+quint64 DatabaseWriter::enqueueTasks(const QList<Task>& tasks) {
+    QMutexLocker locker(&m_mutex);
+    for (const auto& task : tasks) {
+        m_pendingTasks.insert(task.id, task);
+    }
+    return scheduleFlushLocked();
+}
+
+quint64 DatabaseWriter::enqueueEventDeletes(const QStringList& eventIds) {
+    QMutexLocker locker(&m_mutex);
+    for (const QString& id : eventIds) {
+        m_pendingEvents.remove(id);
+        m_pendingEventDeletes.insert(id);
+    }
+    return scheduleFlushLocked();
+}
+
+quint64 DatabaseWriter::scheduleFlushLocked() {
+    const quint64 ticket = ++m_lastTicket;
+    
+    // 已排程的 flush 尚未執行時，新寫入會併入同一批
+    if (!m_flushScheduled) {
+        m_flushScheduled = true;
+        QMetaObject::invokeMethod(this, &DatabaseWriter::flush, Qt::QueuedConnection);
+    }
+    
+    return ticket;
+}
+
+void DatabaseWriter::flush() {
+    QList<CalendarEvent> events;
+    QList<Task> tasks;
+    QStringList deletes;
+    quint64 ticket = 0;
+    
+    {
+        QMutexLocker locker(&m_mutex);
+        events = m_pendingEvents.values();
+        tasks = m_pendingTasks.values();
+        deletes = QStringList(m_pendingEventDeletes.cbegin(), m_pendingEventDeletes.cend());
+        m_pendingEvents.clear();
+        m_pendingTasks.clear();
+        m_pendingEventDeletes.clear();
+        ticket = m_lastTicket;
+        m_flushScheduled = false;
+    }
+    
+    if (ticket == 0 || (events.isEmpty() && tasks.isEmpty() && deletes.isEmpty())) {
+        return;
+    }
+    
+    DatabaseManager::BatchResult result;
+    
+    const DatabaseManager::BatchResult eventResult =
+        DatabaseManager::writeEvents(m_db, events, &m_stats);
+    const DatabaseManager::BatchResult taskResult =
+        DatabaseManager::writeTasks(m_db, tasks, &m_stats);
+    const DatabaseManager::BatchResult deleteResult =
+        DatabaseManager::deleteRows(m_db, "events", deletes);
+    
+    for (const auto& part : {eventResult, taskResult, deleteResult}) {
+        result.succeeded += part.succeeded;
+        result.failedIds += part.failedIds;
+        result.elapsedMs += part.elapsedMs;
+    }
+    result.rowsPerSecond = m_stats.rowsPerSecond();
+    
+    emit flushed(ticket, result);
+}
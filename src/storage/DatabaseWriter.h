@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QObject>
+#include <QSqlDatabase>
+#include <QMutex>
+#include <QHash>
+#include <QSet>
+#include "DatabaseManager.h"
+
+// 背景寫入器 - 於專屬執行緒持有自己的 WAL 連線，批次處理排隊的寫入。
+// enqueue* 可由任何執行緒呼叫；同一 id 在佇列中的多次寫入會合併為最後一次。
+class DatabaseWriter : public QObject {
+    Q_OBJECT
+    
+public:
+    explicit DatabaseWriter(QObject* parent = nullptr);
+    ~DatabaseWriter() override;
+    
+    quint64 enqueueEvents(const QList<CalendarEvent>& events);
+    quint64 enqueueTasks(const QList<Task>& tasks);
+    quint64 enqueueEventDeletes(const QStringList& eventIds);
+    
+public slots:
+    bool open(const QString& dbPath);
+    void close();
+    void flush();
+    
+signals:
+    void flushed(quint64 upToTicket, const DatabaseManager::BatchResult& result);
+    
+private:
+    QSqlDatabase m_db;
+    QString m_connectionName;
+    DatabaseManager::WriteStats m_stats;
+    
+    // 以下成員受 m_mutex 保護
+    QMutex m_mutex;
+    QHash<QString, CalendarEvent> m_pendingEvents;
+    QHash<QString, Task> m_pendingTasks;
+    QSet<QString> m_pendingEventDeletes;
+    quint64 m_lastTicket = 0;
+    bool m_flushScheduled = false;
+    
+    quint64 scheduleFlushLocked();
+};
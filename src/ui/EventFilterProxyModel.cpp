@@ -0,0 +1,45 @@
+#include "EventFilterProxyModel.h"
+#include "EventListModel.h"
+#include "core/TrigramIndex.h"
+
+EventFilterProxyModel::EventFilterProxyModel(QObject* parent)
+    : QSortFilterProxyModel(parent)
+{
+    // 來源模型已依開始時間排序，代理只負責篩選
+    setDynamicSortFilter(false);
+}
+
+void EventFilterProxyModel::setEventModel(EventListModel* model) {
+    m_eventModel = model;
+    setSourceModel(model);
+}
+
+void EventFilterProxyModel::setPlatformFilter(std::optional<Platform> platform) {
+    if (m_platform == platform) {
+        return;
+    }
+    m_platform = platform;
+    invalidateFilter();
+}
+
+void EventFilterProxyModel::setTextFilter(const QString& text) {
+    const QString folded = TrigramIndex::fold(text);
+    if (folded == m_foldedText) {
+        return;
+    }
+    m_foldedText = folded;
+    invalidateFilter();
+}
+
+bool EventFilterProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const {
+    Q_UNUSED(sourceParent);
+    if (!m_eventModel) {
+        return true;
+    }
+    
+    // 合併後的會議只要任一來源符合即顯示
+    if (m_platform && !m_eventModel->hasSourceAt(sourceRow, *m_platform)) {
+        return false;
+    }
+    return m_foldedText.isEmpty() || m_eventModel->filterKeyAt(sourceRow).contains(m_foldedText);
+}
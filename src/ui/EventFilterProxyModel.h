@@ -0,0 +1,30 @@
+#pragma once
+
+#include <QSortFilterProxyModel>
+#include <optional>
+#include "core/CalendarEvent.h"
+
+class EventListModel;
+
+// 事件篩選代理 - 依平台與文字篩選 EventListModel，
+// 直接比對來源模型預先計算的平台與 case folding 鍵。
+class EventFilterProxyModel : public QSortFilterProxyModel {
+    Q_OBJECT
+    
+public:
+    explicit EventFilterProxyModel(QObject* parent = nullptr);
+    
+    void setEventModel(EventListModel* model);
+    
+    // std::nullopt 表示全部平台
+    void setPlatformFilter(std::optional<Platform> platform);
+    void setTextFilter(const QString& text);
+    
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const override;
+    
+private:
+    EventListModel* m_eventModel = nullptr;
+    std::optional<Platform> m_platform;
+    QString m_foldedText;
+};
@@ -0,0 +1,362 @@
+#include "EventListModel.h"
+#include "core/EventMerger.h"
+#include "core/TrigramIndex.h"
+#include <QColor>
+#include <algorithm>
+#include <limits>
+
+EventListModel::EventListModel(QObject* parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int EventListModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : int(m_rows.size());
+}
+
+QVariant EventListModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= m_rows.size()) {
+        return QVariant();
+    }
+    
+    const CalendarEvent& event = m_rows[index.row()].event;
+    switch (role) {
+        case Qt::DisplayRole:
+            return QString("%1 - %2")
+                .arg(event.startTime.toString("yyyy-MM-dd hh:mm"))
+                .arg(event.title);
+        case Qt::ForegroundRole:
+            // 根據平台設定顏色
+            switch (event.platform) {
+                case Platform::Google: return QColor("#4285F4");
+                case Platform::Outlook: return QColor("#0078D4");
+                default: return QVariant();
+            }
+        case Qt::BackgroundRole:
+            return m_rows[index.row()].conflicting ? QVariant(QColor("#FDE7E9")) : QVariant();
+        case Qt::ToolTipRole:
+            return m_rows[index.row()].conflicting ? QString("與其他事件時間重疊\n%1").arg(event.location)
+                                                   : event.location;
+        case PlatformRole:
+            return static_cast<int>(event.platform);
+        case StartTimeRole:
+            return event.startTime;
+        case FilterKeyRole:
+            return m_rows[index.row()].filterKey;
+        case ConflictRole:
+            return m_rows[index.row()].conflicting;
+        default:
+            return QVariant();
+    }
+}
+
+QHash<int, QByteArray> EventListModel::roleNames() const {
+    QHash<int, QByteArray> roles = QAbstractListModel::roleNames();
+    roles.insert(PlatformRole, "platform");
+    roles.insert(StartTimeRole, "startTime");
+    roles.insert(FilterKeyRole, "filterKey");
+    roles.insert(ConflictRole, "conflicting");
+    return roles;
+}
+
+EventListModel::Row EventListModel::makeRow(const QList<CalendarEvent>& sources) const {
+    Row row;
+    row.sources = sources;
+    // 多個來源時依 EventMerger 的規則選出主要事件並補齊欄位
+    row.event = sources.size() == 1 ? sources.first() : EventMerger::mergeDuplicates(sources).first();
+    row.startMs = row.event.startTime.isValid() ? row.event.startTime.toMSecsSinceEpoch()
+                                                : std::numeric_limits<qint64>::max();
+    
+    QStringList parts = {row.event.title, row.event.location, row.event.description};
+    parts += row.event.attendees;
+    row.filterKey = TrigramIndex::fold(parts.join('\n'));
+    row.conflicting = m_conflicts.contains(EventKey::of(row.event));
+    return row;
+}
+
+EventListModel::JoinKey EventListModel::joinKeyOf(const CalendarEvent& event) {
+    return EventMerger::canMerge(event) ? JoinKey(event.iCalUid, event.startTime.toMSecsSinceEpoch()) : JoinKey();
+}
+
+bool EventListModel::rowLess(const Row& a, const Row& b) {
+    if (a.startMs != b.startMs) {
+        return a.startMs < b.startMs;
+    }
+    if (a.event.platform != b.event.platform) {
+        return a.event.platform < b.event.platform;
+    }
+    if (a.event.ownerId != b.event.ownerId) {
+        return a.event.ownerId < b.event.ownerId;
+    }
+    return a.event.id < b.event.id;
+}
+
+void EventListModel::setEvents(const QList<CalendarEvent>& events) {
+    // 同一會議在多個平台上的副本歸入同一列
+    QVector<QList<CalendarEvent>> groups;
+    QHash<JoinKey, int> groupByJoin;
+    for (const auto& event : events) {
+        const JoinKey join = joinKeyOf(event);
+        if (!join.first.isEmpty()) {
+            const auto it = groupByJoin.constFind(join);
+            if (it != groupByJoin.constEnd()) {
+                groups[it.value()].append(event);
+                continue;
+            }
+            groupByJoin.insert(join, int(groups.size()));
+        }
+        groups.append({event});
+    }
+    
+    QVector<Row> incoming;
+    incoming.reserve(groups.size());
+    for (const auto& sources : std::as_const(groups)) {
+        incoming.append(makeRow(sources));
+    }
+    std::sort(incoming.begin(), incoming.end(), rowLess);
+    
+    // 兩個清單依相同順序排序，一次走訪即可找出連續的新增與移除區段
+    int i = 0;
+    int j = 0;
+    while (j < incoming.size()) {
+        if (i == m_rows.size()) {
+            beginInsertRows(QModelIndex(), i, i + int(incoming.size()) - j - 1);
+            m_rows.append(QVector<Row>(incoming.begin() + j, incoming.end()));
+            endInsertRows();
+            i = int(m_rows.size());
+            break;
+        }
+        
+        const Row& next = incoming[j];
+        if (rowLess(m_rows[i], next)) {
+            int last = i;
+            while (last + 1 < m_rows.size() && rowLess(m_rows[last + 1], next)) {
+                ++last;
+            }
+            beginRemoveRows(QModelIndex(), i, last);
+            m_rows.remove(i, last - i + 1);
+            endRemoveRows();
+        } else if (rowLess(next, m_rows[i])) {
+            int last = j;
+            while (last + 1 < incoming.size() && rowLess(incoming[last + 1], m_rows[i])) {
+                ++last;
+            }
+            const int count = last - j + 1;
+            beginInsertRows(QModelIndex(), i, i + count - 1);
+            m_rows.insert(i, count, Row());
+            std::copy(incoming.begin() + j, incoming.begin() + j + count, m_rows.begin() + i);
+            endInsertRows();
+            i += count;
+            j += count;
+        } else {
+            // 同一事件：內容有變才通知更新
+            if (m_rows[i].event != next.event) {
+                m_rows[i] = next;
+                emit dataChanged(index(i), index(i));
+            } else {
+                m_rows[i].sources = next.sources;
+            }
+            ++i;
+            ++j;
+        }
+    }
+    
+    if (i < m_rows.size()) {
+        beginRemoveRows(QModelIndex(), i, int(m_rows.size()) - 1);
+        m_rows.resize(i);
+        endRemoveRows();
+    }
+    
+    rebuildIndex();
+}
+
+void EventListModel::upsertEvents(const QList<CalendarEvent>& events) {
+    for (const auto& event : events) {
+        const EventKey key = EventKey::of(event);
+        const JoinKey join = joinKeyOf(event);
+        
+        // 已在某一列且不需改併入其他列：就地取代該來源
+        const auto existing = m_rowBySource.constFind(key);
+        const int position = existing != m_rowBySource.constEnd() ? findRow(existing.value()) : -1;
+        const bool sameGroup = position >= 0 && !join.first.isEmpty() && join == joinKeyOf(m_rows[position].event);
+        const bool alone = position >= 0 && m_rows[position].sources.size() == 1 &&
+                           (join.first.isEmpty() || !m_rowByJoin.contains(join) || m_rowByJoin.value(join) == existing.value());
+        if (sameGroup || alone) {
+            QList<CalendarEvent> sources = m_rows[position].sources;
+            for (auto& source : sources) {
+                if (EventKey::of(source) == key) {
+                    source = event;
+                }
+            }
+            replaceRow(position, makeRow(sources));
+            continue;
+        }
+        
+        // 其他情況先從原本的列移除，再併入同一會議的列或插入新列
+        removeSource(key);
+        const auto target = join.first.isEmpty() ? m_rowByJoin.constEnd() : m_rowByJoin.constFind(join);
+        const int merged = target != m_rowByJoin.constEnd() ? findRow(target.value()) : -1;
+        if (merged >= 0) {
+            replaceRow(merged, makeRow(m_rows[merged].sources + QList<CalendarEvent>{event}));
+        } else {
+            insertRow(makeRow({event}));
+        }
+    }
+}
+
+void EventListModel::removeEvents(const QList<EventKey>& keys) {
+    for (const EventKey& key : keys) {
+        removeSource(key);
+    }
+}
+
+void EventListModel::removeSeries(const EventKey& masterKey, const QSet<EventKey>& keep) {
+    const QList<EventKey> keys = m_sourcesBySeries.values(masterKey);
+    for (const EventKey& key : keys) {
+        if (!keep.contains(key)) {
+            removeSource(key);
+        }
+    }
+}
+
+int EventListModel::insertPosition(const Row& row) const {
+    return int(std::lower_bound(m_rows.cbegin(), m_rows.cend(), row, rowLess) - m_rows.cbegin());
+}
+
+int EventListModel::findRow(const EventKey& rowKey) const {
+    const auto it = m_startByRow.constFind(rowKey);
+    if (it == m_startByRow.constEnd()) {
+        return -1;
+    }
+    
+    // 列依 (開始時間, 平台, 擁有者, id) 排序，以相同的鍵二分搜尋
+    Row probe;
+    probe.startMs = it.value();
+    probe.event.platform = rowKey.platform;
+    probe.event.ownerId = rowKey.ownerId;
+    probe.event.id = rowKey.id;
+    const int position = insertPosition(probe);
+    return position < m_rows.size() && EventKey::of(m_rows[position].event) == rowKey ? position : -1;
+}
+
+void EventListModel::insertRow(const Row& row) {
+    const int position = insertPosition(row);
+    beginInsertRows(QModelIndex(), position, position);
+    m_rows.insert(position, row);
+    indexRow(row);
+    endInsertRows();
+}
+
+void EventListModel::replaceRow(int position, const Row& row) {
+    unindexRow(m_rows[position]);
+    
+    // 排序鍵不變時就地更新，否則移到新的位置
+    if (!rowLess(row, m_rows[position]) && !rowLess(m_rows[position], row)) {
+        m_rows[position] = row;
+        indexRow(row);
+        emit dataChanged(index(position), index(position));
+        return;
+    }
+    
+    beginRemoveRows(QModelIndex(), position, position);
+    m_rows.remove(position);
+    endRemoveRows();
+    insertRow(row);
+}
+
+void EventListModel::removeSource(const EventKey& key) {
+    const auto it = m_rowBySource.constFind(key);
+    if (it == m_rowBySource.constEnd()) {
+        return;
+    }
+    const int position = findRow(it.value());
+    if (position < 0) {
+        return;
+    }
+    
+    QList<CalendarEvent> sources = m_rows[position].sources;
+    sources.removeIf([&key](const CalendarEvent& source) {
+        return EventKey::of(source) == key;
+    });
+    if (!sources.isEmpty()) {
+        replaceRow(position, makeRow(sources));
+        return;
+    }
+    
+    unindexRow(m_rows[position]);
+    beginRemoveRows(QModelIndex(), position, position);
+    m_rows.remove(position);
+    endRemoveRows();
+}
+
+void EventListModel::indexRow(const Row& row) {
+    const EventKey rowKey = EventKey::of(row.event);
+    m_startByRow.insert(rowKey, row.startMs);
+    for (const auto& source : row.sources) {
+        const EventKey key = EventKey::of(source);
+        m_rowBySource.insert(key, rowKey);
+        if (!source.seriesMasterId.isEmpty()) {
+            m_sourcesBySeries.insert({source.platform, source.ownerId, source.seriesMasterId}, key);
+        }
+        // 搜尋結果已先合併，併入的來源也對應到此列
+        for (const EventSource& merged : source.mergedSources) {
+            m_rowBySource.insert({merged.platform, merged.ownerId, merged.id}, rowKey);
+        }
+    }
+    
+    const JoinKey join = joinKeyOf(row.event);
+    if (!join.first.isEmpty()) {
+        m_rowByJoin.insert(join, rowKey);
+    }
+}
+
+void EventListModel::unindexRow(const Row& row) {
+    const EventKey rowKey = EventKey::of(row.event);
+    m_startByRow.remove(rowKey);
+    for (const auto& source : row.sources) {
+        const EventKey key = EventKey::of(source);
+        m_rowBySource.remove(key);
+        if (!source.seriesMasterId.isEmpty()) {
+            m_sourcesBySeries.remove({source.platform, source.ownerId, source.seriesMasterId}, key);
+        }
+        for (const EventSource& merged : source.mergedSources) {
+            m_rowBySource.remove({merged.platform, merged.ownerId, merged.id});
+        }
+    }
+    
+    const JoinKey join = joinKeyOf(row.event);
+    if (!join.first.isEmpty() && m_rowByJoin.value(join) == rowKey) {
+        m_rowByJoin.remove(join);
+    }
+}
+
+void EventListModel::rebuildIndex() {
+    m_startByRow.clear();
+    m_rowBySource.clear();
+    m_rowByJoin.clear();
+    m_sourcesBySeries.clear();
+    for (const Row& row : std::as_const(m_rows)) {
+        indexRow(row);
+    }
+}
+
+void EventListModel::setConflicts(const QSet<EventKey>& keys) {
+    m_conflicts = keys;
+    for (int row = 0; row < m_rows.size(); ++row) {
+        const bool conflicting = m_conflicts.contains(EventKey::of(m_rows[row].event));
+        if (conflicting != m_rows[row].conflicting) {
+            m_rows[row].conflicting = conflicting;
+            emit dataChanged(index(row), index(row), {Qt::BackgroundRole, Qt::ToolTipRole, ConflictRole});
+        }
+    }
+}
+
+void EventListModel::clear() {
+    if (m_rows.isEmpty()) {
+        return;
+    }
+    beginResetModel();
+    m_rows.clear();
+    rebuildIndex();
+    endResetModel();
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QVector>
+#include <QSet>
+#include <QHash>
+#include <QPair>
+#include "core/CalendarEvent.h"
+#include "core/EventStore.h"
+
+// 事件列表模型 - 顯示文字在 data() 中才格式化；以 setEvents() 比對新舊清單，
+// 只對實際變動的列發出插入、移除與 dataChanged，不會重設整個模型。
+// 同一會議在多個平台上的副本合併為一列；增量變更以來源事件的 EventKey 直接套用到所在的列。
+class EventListModel : public QAbstractListModel {
+    Q_OBJECT
+    
+public:
+    enum Roles {
+        PlatformRole = Qt::UserRole + 1,
+        StartTimeRole,
+        FilterKeyRole,
+        ConflictRole
+    };
+    
+    explicit EventListModel(QObject* parent = nullptr);
+    
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+    
+    // 以新的事件清單取代目前內容（依開始時間排序後逐列比對）
+    void setEvents(const QList<CalendarEvent>& events);
+    void clear();
+    
+    // 插入或更新事件：已有相同 EventKey 的來源時取代之，否則併入同一會議的列或插入新列
+    void upsertEvents(const QList<CalendarEvent>& events);
+    
+    // 移除來源事件；所在的列還有其他來源時只移除該來源
+    void removeEvents(const QList<EventKey>& keys);
+    
+    // 移除重複系列展開出的實例與例外（masterKey 為系列主事件的鍵）；keep 中的來源保留，
+    // 由之後的 upsertEvents 就地更新
+    void removeSeries(const EventKey& masterKey, const QSet<EventKey>& keep = {});
+    
+    // 標示時間衝突的事件，只對狀態改變的列發出 dataChanged
+    void setConflicts(const QSet<EventKey>& keys);
+    
+    const CalendarEvent& eventAt(int row) const { return m_rows[row].event; }
+    
+    // 供篩選代理直接讀取預先計算的鍵，避免經過 QVariant
+    Platform platformAt(int row) const { return m_rows[row].event.platform; }
+    bool hasSourceAt(int row, Platform platform) const { return m_rows[row].event.hasSource(platform); }
+    const QString& filterKeyAt(int row) const { return m_rows[row].filterKey; }
+    
+private:
+    using JoinKey = QPair<QString, qint64>;  // (iCalUID, 開始時間)
+    
+    struct Row {
+        CalendarEvent event;           // 合併後顯示的事件
+        QList<CalendarEvent> sources;  // 合併前的來源事件
+        qint64 startMs = 0;
+        QString filterKey;  // case folding 後的標題、地點、描述與參與者
+        bool conflicting = false;
+    };
+    
+    Row makeRow(const QList<CalendarEvent>& sources) const;
+    static bool rowLess(const Row& a, const Row& b);
+    static JoinKey joinKeyOf(const CalendarEvent& event);
+    
+    int findRow(const EventKey& rowKey) const;
+    int insertPosition(const Row& row) const;
+    void insertRow(const Row& row);
+    void replaceRow(int position, const Row& row);
+    void removeSource(const EventKey& key);
+    void indexRow(const Row& row);
+    void unindexRow(const Row& row);
+    void rebuildIndex();
+    
+    QVector<Row> m_rows;
+    QSet<EventKey> m_conflicts;
+    
+    // 增量變更的查找索引：列以主要事件的鍵識別，依開始時間二分搜尋
+    QHash<EventKey, qint64> m_startByRow;
+    QHash<EventKey, EventKey> m_rowBySource;
+    QHash<JoinKey, EventKey> m_rowByJoin;
+    QMultiHash<EventKey, EventKey> m_sourcesBySeries;
+};
@@ -0,0 +1,96 @@
+#include "EventSearchController.h"
+#include <QtConcurrent/QtConcurrentRun>
+#include <QPromise>
+#include <QDebug>
+
+namespace {
+
+// 輸入停頓多久後才開始搜尋
+constexpr int kDefaultDebounceMs = 150;
+
+} // namespace
+
+EventSearchController::EventSearchController(CalendarManager* manager, QObject* parent)
+    : QObject(parent)
+    , m_manager(manager)
+{
+    m_debounceTimer.setSingleShot(true);
+    m_debounceTimer.setInterval(kDefaultDebounceMs);
+    connect(&m_debounceTimer, &QTimer::timeout, this, &EventSearchController::startSearch);
+    connect(&m_watcher, &QFutureWatcher<CalendarManager::SearchResult>::finished,
+            this, &EventSearchController::onSearchFinished);
+}
+
+EventSearchController::~EventSearchController() {
+    // 背景工作持有 manager 指標，必須在此等待結束
+    cancelPending();
+    m_watcher.waitForFinished();
+}
+
+void EventSearchController::setQuery(const QString& query) {
+    m_query = query;
+    ++m_generation;
+    
+    if (query.isEmpty()) {
+        m_debounceTimer.stop();
+        cancelPending();
+        m_lastResult = CalendarManager::SearchResult();
+        return;
+    }
+    
+    m_debounceTimer.start();
+}
+
+void EventSearchController::refresh() {
+    if (m_query.isEmpty()) {
+        return;
+    }
+    
+    // 事件已變更，前次結果的 revision 不再相符，會自動改為完整搜尋
+    ++m_generation;
+    m_debounceTimer.stop();
+    startSearch();
+}
+
+void EventSearchController::cancelPending() {
+    if (m_watcher.isRunning()) {
+        m_watcher.cancel();
+    }
+}
+
+void EventSearchController::startSearch() {
+    cancelPending();
+    if (m_query.isEmpty()) {
+        return;
+    }
+    
+    m_runningGeneration = m_generation;
+    
+    CalendarManager* manager = m_manager;
+    const QString query = m_query;
+    const CalendarManager::SearchResult previous = m_lastResult;
+    
+    QFuture<CalendarManager::SearchResult> future = QtConcurrent::run(
+        [manager, query, previous](QPromise<CalendarManager::SearchResult>& promise) {
+            CalendarManager::SearchResult result = manager->searchConcurrent(
+                query, &previous, [&promise]() { return promise.isCanceled(); });
+            if (!promise.isCanceled()) {
+                promise.addResult(std::move(result));
+            }
+        });
+    m_watcher.setFuture(future);
+}
+
+void EventSearchController::onSearchFinished() {
+    if (m_watcher.isCanceled() || m_watcher.future().resultCount() == 0) {
+        return;
+    }
+    
+    // 搜尋期間查詢已變更，結果作廢
+    if (m_runningGeneration != m_generation) {
+        return;
+    }
+    
+    m_lastResult = m_watcher.result();
+    emit resultsReady(m_lastResult.query, m_lastResult.events);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <QFuture>
+#include <QFutureWatcher>
+#include "core/CalendarManager.h"
+
+// 事件搜尋控制器 - 輸入停頓後才在背景執行緒搜尋，新查詢會取消尚未完成的舊查詢，
+// 只有最新一次查詢的結果會送回主執行緒。查詢字串延長時沿用前次結果縮小範圍。
+class EventSearchController : public QObject {
+    Q_OBJECT
+    
+public:
+    explicit EventSearchController(CalendarManager* manager, QObject* parent = nullptr);
+    ~EventSearchController() override;
+    
+    void setDebounceInterval(int msec) { m_debounceTimer.setInterval(msec); }
+    
+    // 每次輸入變更時呼叫；空字串會立即取消進行中的搜尋
+    void setQuery(const QString& query);
+    
+    // 事件內容變更後以目前查詢重新搜尋（不等待輸入停頓）
+    void refresh();
+    
+    QString query() const { return m_query; }
+    
+signals:
+    void resultsReady(const QString& query, const QList<CalendarEvent>& events);
+    
+private slots:
+    void startSearch();
+    void onSearchFinished();
+    
+private:
+    void cancelPending();
+    
+    CalendarManager* m_manager;
+    QTimer m_debounceTimer;
+    QFutureWatcher<CalendarManager::SearchResult> m_watcher;
+    QString m_query;
+    quint64 m_generation = 0;
+    quint64 m_runningGeneration = 0;
+    
+    // 最近一次送出的結果，供查詢延長時縮小範圍
+    CalendarManager::SearchResult m_lastResult;
+};
@@ -9,6 +9,7 @@
 #include <QMenuBar>
 #include <QMenu>
 #include <QAction>
+#include <QDebug>
 
 MainWindow::MainWindow(QWidget* parent)
     : QMainWindow(parent)
@@ -19,18 +20,48 @@ MainWindow::MainWindow(QWidget* parent)
     m_dbManager = new DatabaseManager(this);
     if (!m_dbManager->initialize("calendar.db")) {
         QMessageBox::critical(this, "錯誤", "資料庫初始化失敗！");
+    } else {
+        // 寫入改由背景執行緒處理，避免同步時凍結視窗
+        m_dbManager->enableAsyncWrites();
     }
+    connect(m_dbManager, &DatabaseManager::writesFlushed,
+            this, [](quint64, const DatabaseManager::BatchResult& result) {
+        if (!result.failedIds.isEmpty()) {
+            qWarning() << "有" << result.failedIds.size() << "筆資料寫入資料庫失敗";
+        }
+    });
     
     // 初始化行事曆管理器
     m_manager = new CalendarManager(this);
+    m_manager->setDatabase(m_dbManager);
+    
+    // 搜尋在背景執行緒進行，只有最新查詢的結果會回到主執行緒
+    m_searchController = new EventSearchController(m_manager, this);
+    connect(m_searchController, &EventSearchController::resultsReady,
+            this, &MainWindow::onSearchResultsReady);
     
     // 初始化適配器
     m_googleAdapter = new GoogleCalendarAdapter(this);
+    // 只下載系列主事件與例外，由 CalendarManager 依檢視範圍在本地展開
+    m_googleAdapter->setExpandRecurrencesLocally(true);
     m_outlookAdapter = new OutlookCalendarAdapter(this);
+    // 先顯示上次的結果，再於背景重新驗證
+    m_googleAdapter->setStaleWhileRevalidate(true);
+    m_outlookAdapter->setStaleWhileRevalidate(true);
     
     // 連接信號
-    connect(m_manager, &CalendarManager::eventsUpdated,
-            this, &MainWindow::onEventsUpdated);
+    connect(m_manager, &CalendarManager::eventsAdded,
+            this, &MainWindow::onEventsAdded);
+    connect(m_manager, &CalendarManager::eventsChanged,
+            this, &MainWindow::onEventsChanged);
+    connect(m_manager, &CalendarManager::eventsRemoved,
+            this, &MainWindow::onEventsRemoved);
+    connect(m_manager, &CalendarManager::eventsReset,
+            this, &MainWindow::onEventsReset);
+    connect(m_manager, &CalendarManager::conflictsDetected,
+            this, &MainWindow::onConflictsDetected);
+    connect(m_manager, &CalendarManager::fetchCompleted,
+            this, &MainWindow::onFetchCompleted);
     connect(m_manager, &CalendarManager::errorOccurred,
             this, &MainWindow::onErrorOccurred);
     
@@ -44,7 +75,10 @@ MainWindow::MainWindow(QWidget* parent)
     updateStatusBar("就緒 - 請先進行帳號認證");
 }
 
-MainWindow::~MainWindow() = default;
+MainWindow::~MainWindow() {
+    // 先停止背景搜尋，再讓子物件（含 CalendarManager）依序銷毀
+    delete m_searchController;
+}
 
 void MainWindow::setupUI() {
     setWindowTitle("Qt 多平台行事曆整合工具");
@@ -139,6 +173,8 @@ void MainWindow::setupUI() {
     platformLayout->addWidget(new QLabel("平台:"));
     m_platformFilter = new QComboBox();
     m_platformFilter->addItems({"全部", "Google", "Outlook"});
+    connect(m_platformFilter, &QComboBox::currentIndexChanged,
+            this, &MainWindow::onPlatformFilterChanged);
     platformLayout->addWidget(m_platformFilter);
     
     m_fetchEventsBtn = new QPushButton("獲取事件");
@@ -155,8 +191,15 @@ void MainWindow::setupUI() {
     QGroupBox* eventListGroup = new QGroupBox("事件列表");
     QVBoxLayout* eventListLayout = new QVBoxLayout(eventListGroup);
     
-    m_eventList = new QListWidget();
-    connect(m_eventList, &QListWidget::itemClicked,
+    // 模型/檢視：列在顯示時才格式化，固定列高讓檢視不必逐列量測
+    m_eventModel = new EventListModel(this);
+    m_eventProxy = new EventFilterProxyModel(this);
+    m_eventProxy->setEventModel(m_eventModel);
+    
+    m_eventList = new QListView();
+    m_eventList->setUniformItemSizes(true);
+    m_eventList->setModel(m_eventProxy);
+    connect(m_eventList, &QListView::clicked,
             this, &MainWindow::onEventSelected);
     eventListLayout->addWidget(m_eventList);
     
@@ -210,6 +253,11 @@ void MainWindow::onGoogleAuthClicked() {
     }
     
     m_googleAdapter->setCredentials(clientId, clientSecret);
+    // 除了 primary 之外要同步的行事曆（共用、訂閱），以逗號分隔
+    const QString calendarIds = qEnvironmentVariable("GOOGLE_CALENDAR_IDS");
+    if (!calendarIds.isEmpty()) {
+        m_googleAdapter->setCalendarIds(QStringList{"primary"} + calendarIds.split(',', Qt::SkipEmptyParts));
+    }
     m_googleAdapter->authenticate();
 }
 
@@ -287,48 +335,130 @@ void MainWindow::onFetchEventsClicked() {
                    .arg(start.toString("yyyy-MM-dd"))
                    .arg(end.toString("yyyy-MM-dd")));
     
-    m_manager->fetchAllEvents(start, end);
+    // 增量同步：首次取得完整範圍，之後只取得變更
+    m_manager->syncAllEvents(start, end);
 }
 
 void MainWindow::onSearchTextChanged(const QString& text) {
+    // 代理先就地篩選目前的列；完整結果在輸入停頓後由背景搜尋提供
+    m_eventProxy->setTextFilter(text);
+    m_searchController->setQuery(text);
     if (text.isEmpty()) {
-        updateEventList(m_currentEvents);
+        refreshEventList();
+    }
+}
+
+void MainWindow::onSearchResultsReady(const QString& query, const QList<CalendarEvent>& events) {
+    if (query != m_searchEdit->text()) {
         return;
     }
-    
-    // 簡單的搜尋過濾
-    QList<CalendarEvent> filtered;
-    for (const auto& event : m_currentEvents) {
-        if (event.title.contains(text, Qt::CaseInsensitive) ||
-            event.description.contains(text, Qt::CaseInsensitive) ||
-            event.location.contains(text, Qt::CaseInsensitive)) {
-            filtered.append(event);
-        }
+    updateEventList(events);
+}
+
+void MainWindow::refreshEventList() {
+    const QString text = m_searchEdit->text();
+    if (text.isEmpty()) {
+        // 重複事件在顯示範圍內展開
+        const QDateTime start(m_startDateEdit->date(), QTime(0, 0));
+        const QDateTime end(m_endDateEdit->date(), QTime(23, 59, 59));
+        updateEventList(m_manager->expandedEvents(start, end));
+        return;
     }
     
-    updateEventList(filtered);
+    // 事件變更後在背景重新搜尋，結果由 onSearchResultsReady 顯示
+    m_searchController->refresh();
 }
 
-void MainWindow::onEventSelected(QListWidgetItem* item) {
-    if (!item) return;
+void MainWindow::onEventSelected(const QModelIndex& index) {
+    if (!index.isValid()) return;
     
-    // 使用顯示的事件列表，而非所有事件
-    int index = m_eventList->row(item);
-    if (index >= 0 && index < m_displayedEvents.size()) {
-        showEventDetails(m_displayedEvents[index]);
+    // 代理的列對應回來源模型中的事件
+    const QModelIndex sourceIndex = m_eventProxy->mapToSource(index);
+    if (sourceIndex.isValid()) {
+        showEventDetails(m_eventModel->eventAt(sourceIndex.row()));
     }
 }
 
-void MainWindow::onEventsUpdated(const QList<CalendarEvent>& events) {
-    m_currentEvents = events;
-    updateEventList(events);
+void MainWindow::onPlatformFilterChanged(int index) {
+    switch (index) {
+        case 1: m_eventProxy->setPlatformFilter(Platform::Google); break;
+        case 2: m_eventProxy->setPlatformFilter(Platform::Outlook); break;
+        default: m_eventProxy->setPlatformFilter(std::nullopt); break;
+    }
+}
+
+void MainWindow::applyEventChanges(const QList<CalendarEvent>& events) {
+    // 搜尋中改為在背景重新搜尋，結果由 onSearchResultsReady 顯示
+    if (!m_searchEdit->text().isEmpty()) {
+        m_searchController->refresh();
+        return;
+    }
     
-    // 儲存到資料庫
-    for (const auto& event : events) {
-        m_dbManager->saveEvent(event);
+    // 只重新計算受影響的事件與系列，不重新展開整個範圍
+    const QDateTime start(m_startDateEdit->date(), QTime(0, 0));
+    const QDateTime end(m_endDateEdit->date(), QTime(23, 59, 59));
+    QList<EventKey> series;
+    const QList<CalendarEvent> current = m_manager->expandedEventsFor(events, start, end, &series);
+    
+    QSet<EventKey> currentKeys;
+    for (const auto& event : current) {
+        currentKeys.insert(EventKey::of(event));
     }
     
-    updateStatusBar(QString("已獲取 %1 個事件").arg(events.size()));
+    // 不再顯示的列先移除；事件本身可能曾是系列主事件，舊的展開結果一併移除
+    QList<EventKey> removed;
+    for (const auto& event : events) {
+        const EventKey key = EventKey::of(event);
+        series.append(key);
+        if (!currentKeys.contains(key)) {
+            removed.append(key);
+        }
+    }
+    m_eventModel->removeEvents(removed);
+    for (const EventKey& masterKey : std::as_const(series)) {
+        m_eventModel->removeSeries(masterKey, currentKeys);
+    }
+    m_eventModel->upsertEvents(current);
+}
+
+void MainWindow::onEventsAdded(const QList<CalendarEvent>& events) {
+    // 只儲存新增的事件（背景執行緒批次寫入）
+    m_dbManager->saveEventsAsync(events);
+    applyEventChanges(events);
+    
+    updateStatusBar(QString("已獲取 %1 個事件（新增 %2 個）")
+                   .arg(m_manager->eventCount())
+                   .arg(events.size()));
+}
+
+void MainWindow::onEventsChanged(const QList<CalendarEvent>& events) {
+    m_dbManager->saveEventsAsync(events);
+    applyEventChanges(events);
+}
+
+void MainWindow::onEventsRemoved(const QList<CalendarEvent>& events) {
+    QStringList eventIds;
+    for (const auto& event : events) {
+        eventIds.append(event.id);
+    }
+    m_dbManager->deleteEventsAsync(eventIds);
+    applyEventChanges(events);
+}
+
+void MainWindow::onEventsReset() {
+    refreshEventList();
+}
+
+void MainWindow::onConflictsDetected(const QList<ConflictDetector::Conflict>& conflicts) {
+    m_eventModel->setConflicts(m_manager->conflictingEvents());
+    if (!conflicts.isEmpty()) {
+        updateStatusBar(QString("發現 %1 組時間衝突").arg(conflicts.size()));
+    }
+}
+
+void MainWindow::onFetchCompleted(Platform platform, int eventCount) {
+    const QString platformName = platform == Platform::Google ? "Google Calendar" : "Microsoft Outlook";
+    updateStatusBar(QString("%1 已取得全部 %2 個事件").arg(platformName).arg(eventCount));
 }
 
 void MainWindow::onErrorOccurred(const QString& error) {
@@ -337,57 +467,27 @@ void MainWindow::onErrorOccurred(const QString& error) {
 }
 
 void MainWindow::updateEventList(const QList<CalendarEvent>& events) {
-    m_eventList->clear();
-    m_displayedEvents.clear();  // 清除顯示的事件列表
-    
-    QString platformFilter = m_platformFilter->currentText();
-    
-    for (const auto& event : events) {
-        // 平台篩選
-        if (platformFilter != "全部") {
-            QString platform;
-            switch (event.platform) {
-                case Platform::Google: platform = "Google"; break;
-                case Platform::Outlook: platform = "Outlook"; break;
-                default: platform = "Unknown"; break;
-            }
-            if (platform != platformFilter) {
-                continue;
-            }
-        }
-        
-        // 將事件加入顯示列表
-        m_displayedEvents.append(event);
-        
-        QString itemText = QString("%1 - %2")
-            .arg(event.startTime.toString("yyyy-MM-dd hh:mm"))
-            .arg(event.title);
-        
-        QListWidgetItem* item = new QListWidgetItem(itemText);
-        
-        // 根據平台設定顏色
-        switch (event.platform) {
-            case Platform::Google:
-                item->setForeground(QColor("#4285F4"));
-                break;
-            case Platform::Outlook:
-                item->setForeground(QColor("#0078D4"));
-                break;
-            default:
-                break;
-        }
-        
-        m_eventList->addItem(item);
-    }
+    // 模型只對變動的列發出插入、移除與更新，平台篩選由代理處理
+    m_eventModel->setEvents(events);
 }
 
 void MainWindow::showEventDetails(const CalendarEvent& event) {
-    QString platformName;
-    switch (event.platform) {
-        case Platform::Google: platformName = "Google Calendar"; break;
-        case Platform::Outlook: platformName = "Microsoft Outlook"; break;
-        default: platformName = "Unknown"; break;
+    auto nameOf = [](Platform platform) -> QString {
+        switch (platform) {
+            case Platform::Google: return "Google Calendar";
+            case Platform::Outlook: return "Microsoft Outlook";
+            default: return "Unknown";
+        }
+    };
+    
+    // 合併的重複會議列出所有來源平台
+    QStringList platformNames = {nameOf(event.platform)};
+    for (const EventSource& source : event.mergedSources) {
+        if (!platformNames.contains(nameOf(source.platform))) {
+            platformNames.append(nameOf(source.platform));
+        }
     }
+    const QString platformName = platformNames.join(" / ");
     
     QString details = QString(
         "<h2>%1</h2>"
@@ -2,7 +2,7 @@
 
 #include <QMainWindow>
 #include <QTreeWidget>
-#include <QListWidget>
+#include <QListView>
 #include <QTextEdit>
 #include <QPushButton>
 #include <QLineEdit>
@@ -14,6 +14,9 @@
 #include "adapters/GoogleCalendarAdapter.h"
 #include "adapters/OutlookCalendarAdapter.h"
 #include "storage/DatabaseManager.h"
+#include "EventSearchController.h"
+#include "EventListModel.h"
+#include "EventFilterProxyModel.h"
 
 class MainWindow : public QMainWindow {
     Q_OBJECT
@@ -27,8 +30,15 @@ private slots:
     void onOutlookAuthClicked();
     void onFetchEventsClicked();
     void onSearchTextChanged(const QString& text);
-    void onEventSelected(QListWidgetItem* item);
-    void onEventsUpdated(const QList<CalendarEvent>& events);
+    void onSearchResultsReady(const QString& query, const QList<CalendarEvent>& events);
+    void onEventSelected(const QModelIndex& index);
+    void onPlatformFilterChanged(int index);
+    void onEventsAdded(const QList<CalendarEvent>& events);
+    void onEventsChanged(const QList<CalendarEvent>& events);
+    void onEventsRemoved(const QList<CalendarEvent>& events);
+    void onEventsReset();
+    void onConflictsDetected(const QList<ConflictDetector::Conflict>& conflicts);
+    void onFetchCompleted(Platform platform, int eventCount);
     void onErrorOccurred(const QString& error);
     void onGoogleAuthenticated();
     void onOutlookAuthenticated();
@@ -36,13 +46,17 @@ private slots:
 private:
     void setupUI();
     void updateEventList(const QList<CalendarEvent>& events);
+    void refreshEventList();
+    void applyEventChanges(const QList<CalendarEvent>& events);
     void showEventDetails(const CalendarEvent& event);
     void updateStatusBar(const QString& message);
     
     // UI 元件
     QWidget* m_centralWidget;
     QTreeWidget* m_calendarTree;
-    QListWidget* m_eventList;
+    QListView* m_eventList;
+    EventListModel* m_eventModel;
+    EventFilterProxyModel* m_eventProxy;
     QTextEdit* m_eventDetails;
     QPushButton* m_googleAuthBtn;
     QPushButton* m_outlookAuthBtn;
@@ -58,10 +72,9 @@ private:
     GoogleCalendarAdapter* m_googleAdapter;
     OutlookCalendarAdapter* m_outlookAdapter;
     DatabaseManager* m_dbManager;
+    EventSearchController* m_searchController;
     
     // 資料
-    QList<CalendarEvent> m_currentEvents;  // 所有事件
-    QList<CalendarEvent> m_displayedEvents;  // 目前顯示的事件（已過濾）
     bool m_googleAuthenticated;
     bool m_outlookAuthenticated;
 };
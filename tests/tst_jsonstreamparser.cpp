@@ -0,0 +1,210 @@
+#include <QtTest>
+#include <QJsonDocument>
+#include <QRandomGenerator>
+#include <algorithm>
+#include "adapters/JsonStreamParser.h"
+
+// 串流 JSON 解析 - 分段餵入的結果必須與 QJsonDocument 一次解析完全相同
+class TestJsonStreamParser : public QObject {
+    Q_OBJECT
+    
+private slots:
+    void matchesDocument_data();
+    void matchesDocument();
+    void everySplitPoint_data();
+    void everySplitPoint();
+    void rejectsInvalidInput_data();
+    void rejectsInvalidInput();
+    
+private:
+    struct Output {
+        bool ok = true;
+        int itemCount = 0;
+        QList<QJsonObject> items;
+        QJsonObject fields;
+    };
+    
+    static void addDocuments();
+    static QList<QByteArray> randomChunks(const QByteArray& json, quint32 seed);
+    static Output parse(const QList<QByteArray>& chunks, const QString& arrayKey);
+    static QString describeMismatch(const Output& output, const QByteArray& json, const QString& arrayKey);
+};
+
+void TestJsonStreamParser::addDocuments() {
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<QString>("arrayKey");
+    
+    // Google events.list 分頁：引號、反斜線、控制字元與 \u 逸出
+    QTest::newRow("google page") << QByteArray(R"({"kind":"calendar#events","nextPageToken":"CiAKGjBpNDd2Nmp2Zml2cXRwYjBpOXA",)"
+        R"("items":[{"id":"evt1","summary":"週會 \"產品\" 討論","start":{"dateTime":"2024-01-01T09:00:00+08:00"},)"
+        R"("attendees":[{"email":"a@example.com","responseStatus":"accepted"},{"email":"b@example.com"}]},)"
+        R"({"id":"evt2","summary":"路徑 C:\\temp\\cal\\","description":"第一行\n第二行\t\u00e9\u4e2d\/\b\f\r",)"
+        R"("status":"cancelled"}],"nextSyncToken":"CPjX"})") << QString("items");
+    
+    // Graph calendarView 分頁：代理對逸出與未逸出的多位元組 UTF-8
+    QTest::newRow("graph surrogates") << QByteArray(R"({"@odata.context":"https://graph.microsoft.com/v1.0/$metadata",)"
+        R"("value":[{"subject":"\ud83d\ude00 慶功宴 😀","body":{"content":"\u0041\u00e9\u20ac\ud834\udd1e"}},)"
+        R"({"subject":"","categories":["紅","\u7da0","🎉🎉"],"empty":{},"list":[]}],)"
+        R"("@odata.nextLink":"https://graph.microsoft.com/v1.0/me/calendarView?$skiptoken=abc%3D"})") << QString("value");
+    
+    // 整數、負數、小數與指數
+    QTest::newRow("numbers") << QByteArray(R"({"items":[{"n":0,"neg":-17,"dec":3.14159,"exp":6.02e23,)"
+        R"("negexp":-1.5E-7,"plus":1e+2,"big":9007199254740993,"huge":12345678901234567890,)"
+        R"("arr":[1,-2,3.5,-0.25,100000]},{"n":42},{"n":-0.5}],"total":-3,"ratio":0.125})") << QString("items");
+    
+    // 常值、巢狀結構，以及元素內同名的陣列（不可被當成串流陣列）
+    QTest::newRow("literals and nesting") << QByteArray(R"({"items":[{"ok":true,"no":false,"nil":null,)"
+        R"("deep":{"a":[{"b":[[],[null]]},{"items":[1,2]}]}},{}],"done":true,"meta":null,"list":[false,{"x":"y"}]})")
+        << QString("items");
+    
+    // 空白、鍵中的逸出字元
+    QTest::newRow("whitespace and escaped keys") << QByteArray("{\r\n  \"items\" : [\n\t{ \"k\\\"ey\" : \"v\\\\\" ,"
+        " \"x\" : [ 1 , 2.5e-1 ] , \"\\u00e9t\\u00e9\" : true }\n ] ,\n \"next\" : \"\\u0022quoted\\u0022\"\n}\n")
+        << QString("items");
+    
+    QTest::newRow("empty items") << QByteArray(R"({"items":[],"nextSyncToken":"x"})") << QString("items");
+    QTest::newRow("no array") << QByteArray(R"({"error":{"code":410,"message":"Gone","errors":[{"reason":"fullSyncRequired"}]}})")
+        << QString("items");
+}
+
+QList<QByteArray> TestJsonStreamParser::randomChunks(const QByteArray& json, quint32 seed) {
+    QList<QByteArray> chunks;
+    if (seed == 0) {
+        // 逐位元組餵入
+        for (char c : json) {
+            chunks.append(QByteArray(1, c));
+        }
+        return chunks;
+    }
+    
+    QRandomGenerator random(seed);
+    const int maxChunk = random.bounded(2, 24);
+    for (int offset = 0; offset < json.size();) {
+        const int size = random.bounded(1, maxChunk + 1);
+        chunks.append(json.mid(offset, size));
+        offset += size;
+    }
+    return chunks;
+}
+
+TestJsonStreamParser::Output TestJsonStreamParser::parse(const QList<QByteArray>& chunks, const QString& arrayKey) {
+    Output output;
+    JsonStreamParser parser(arrayKey);
+    parser.setItemHandler([&output](const QJsonObject& item) {
+        output.items.append(item);
+    });
+    parser.setFieldHandler([&output](const QString& key, const QJsonValue& value) {
+        output.fields.insert(key, value);
+    });
+    
+    for (const QByteArray& chunk : chunks) {
+        if (!parser.feed(chunk)) {
+            break;
+        }
+    }
+    output.ok = parser.finish() && !parser.hasError();
+    output.itemCount = parser.itemCount();
+    return output;
+}
+
+QString TestJsonStreamParser::describeMismatch(const Output& output, const QByteArray& json, const QString& arrayKey) {
+    const QJsonObject root = QJsonDocument::fromJson(json).object();
+    const QJsonArray expectedItems = root.value(arrayKey).toArray();
+    QJsonObject expectedFields = root;
+    expectedFields.remove(arrayKey);
+    
+    if (!output.ok) {
+        return "串流解析失敗";
+    }
+    if (output.items.size() != expectedItems.size() || output.itemCount != expectedItems.size()) {
+        return QString("元素數量 %1（itemCount %2），預期 %3")
+            .arg(output.items.size()).arg(output.itemCount).arg(expectedItems.size());
+    }
+    for (int i = 0; i < expectedItems.size(); ++i) {
+        const QJsonObject expected = expectedItems[i].toObject();
+        if (output.items[i] != expected) {
+            return QString("第 %1 個元素不同：\n  實際 %2\n  預期 %3").arg(i)
+                .arg(QString::fromUtf8(QJsonDocument(output.items[i]).toJson(QJsonDocument::Compact)),
+                     QString::fromUtf8(QJsonDocument(expected).toJson(QJsonDocument::Compact)));
+        }
+    }
+    if (output.fields != expectedFields) {
+        return QString("根物件欄位不同：\n  實際 %1\n  預期 %2")
+            .arg(QString::fromUtf8(QJsonDocument(output.fields).toJson(QJsonDocument::Compact)),
+                 QString::fromUtf8(QJsonDocument(expectedFields).toJson(QJsonDocument::Compact)));
+    }
+    return QString();
+}
+
+void TestJsonStreamParser::matchesDocument_data() {
+    addDocuments();
+}
+
+void TestJsonStreamParser::matchesDocument() {
+    QFETCH(QByteArray, json);
+    QFETCH(QString, arrayKey);
+    
+    QJsonParseError error;
+    QJsonDocument::fromJson(json, &error);
+    QVERIFY2(error.error == QJsonParseError::NoError, qPrintable(error.errorString()));
+    
+    // 一次餵入、逐位元組（種子 0），以及固定種子的隨機切段
+    const QString whole = describeMismatch(parse({json}, arrayKey), json, arrayKey);
+    QVERIFY2(whole.isEmpty(), qPrintable(whole));
+    for (quint32 seed = 0; seed <= 64; ++seed) {
+        const QString mismatch = describeMismatch(parse(randomChunks(json, seed), arrayKey), json, arrayKey);
+        QVERIFY2(mismatch.isEmpty(), qPrintable(QString("種子 %1：%2").arg(seed).arg(mismatch)));
+    }
+}
+
+void TestJsonStreamParser::everySplitPoint_data() {
+    addDocuments();
+}
+
+void TestJsonStreamParser::everySplitPoint() {
+    QFETCH(QByteArray, json);
+    QFETCH(QString, arrayKey);
+    
+    // 每個位置都切一次，涵蓋字串、逸出序列、代理對、UTF-8 多位元組與數字被切開的情況
+    for (int split = 1; split < json.size(); ++split) {
+        const QList<QByteArray> chunks = {json.left(split), json.mid(split)};
+        const QString mismatch = describeMismatch(parse(chunks, arrayKey), json, arrayKey);
+        QVERIFY2(mismatch.isEmpty(), qPrintable(QString("切在位置 %1（\"%2|%3\"）：%4").arg(split)
+            .arg(QString::fromUtf8(json.mid(std::max(0, split - 8), std::min(split, 8))),
+                 QString::fromUtf8(json.mid(split, 8)), mismatch)));
+    }
+}
+
+void TestJsonStreamParser::rejectsInvalidInput_data() {
+    QTest::addColumn<QByteArray>("json");
+    
+    QTest::newRow("truncated") << QByteArray(R"({"items":[{"a":1})");
+    QTest::newRow("unterminated string") << QByteArray(R"({"items":[{"a":"abc)");
+    QTest::newRow("truncated literal") << QByteArray(R"({"items":[{"a":tr)");
+    QTest::newRow("bad escape") << QByteArray(R"({"items":[{"a":"\x"}]})");
+    QTest::newRow("bad unicode escape") << QByteArray(R"({"items":[{"a":"\u12G4"}]})");
+    QTest::newRow("short unicode escape") << QByteArray(R"({"items":[{"a":"\u12"}]})");
+    QTest::newRow("bad literal") << QByteArray(R"({"items":[{"a":nul}]})");
+    QTest::newRow("bad number") << QByteArray(R"({"items":[{"a":1.2.3}]})");
+    QTest::newRow("lone minus") << QByteArray(R"({"items":[{"a":-}]})");
+    QTest::newRow("mismatched brackets") << QByteArray(R"({"items":[{"a":1]]})");
+    QTest::newRow("unexpected character") << QByteArray(R"({"items":[@]})");
+    QTest::newRow("data after root") << QByteArray(R"({"items":[]}{"items":[]})");
+}
+
+void TestJsonStreamParser::rejectsInvalidInput() {
+    QFETCH(QByteArray, json);
+    
+    QJsonParseError error;
+    QJsonDocument::fromJson(json, &error);
+    QVERIFY(error.error != QJsonParseError::NoError);
+    
+    for (quint32 seed = 0; seed <= 16; ++seed) {
+        const Output output = parse(randomChunks(json, seed), "items");
+        QVERIFY2(!output.ok, qPrintable(QString("種子 %1 未回報錯誤").arg(seed)));
+    }
+    QVERIFY(!parse({json}, "items").ok);
+}
+
+QTEST_GUILESS_MAIN(TestJsonStreamParser)
+#include "tst_jsonstreamparser.moc"
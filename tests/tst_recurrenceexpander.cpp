@@ -0,0 +1,209 @@
+#include <QtTest>
+#include <QTimeZone>
+#include "core/RecurrenceExpander.h"
+
+// 重複事件展開 - 以表格列出 RRULE、例外與預期的本地開始時間
+class TestRecurrenceExpander : public QObject {
+    Q_OBJECT
+    
+private slots:
+    void expand_data();
+    void expand();
+    void setPositionsFromParse();
+    
+private:
+    static QDateTime local(const QString& text, const QTimeZone& zone);
+};
+
+QDateTime TestRecurrenceExpander::local(const QString& text, const QTimeZone& zone) {
+    const QDateTime parsed = QDateTime::fromString(text, "yyyy-MM-dd'T'HH:mm");
+    return QDateTime(parsed.date(), parsed.time(), zone);
+}
+
+void TestRecurrenceExpander::expand_data() {
+    QTest::addColumn<QByteArray>("zoneId");
+    QTest::addColumn<QString>("dtstart");
+    QTest::addColumn<QString>("rule");
+    QTest::addColumn<QString>("rangeStart");
+    QTest::addColumn<QString>("rangeEnd");
+    // 「原本時間>新時間」或「原本時間>cancelled」
+    QTest::addColumn<QStringList>("overrides");
+    QTest::addColumn<QStringList>("expected");
+    
+    const QByteArray newYork = "America/New_York";
+    
+    // BYDAY
+    QTest::newRow("weekly byday")
+        << newYork << "2024-01-01T09:00" << "RRULE:FREQ=WEEKLY;BYDAY=MO,WE;COUNT=4"
+        << "2024-01-01T00:00" << "2024-02-01T00:00" << QStringList()
+        << QStringList{"2024-01-01T09:00", "2024-01-03T09:00", "2024-01-08T09:00", "2024-01-10T09:00"};
+    QTest::newRow("weekly interval wkst")
+        << newYork << "2024-01-07T09:00" << "RRULE:FREQ=WEEKLY;INTERVAL=2;BYDAY=SU,TU;WKST=SU;COUNT=4"
+        << "2024-01-01T00:00" << "2024-03-01T00:00" << QStringList()
+        << QStringList{"2024-01-07T09:00", "2024-01-09T09:00", "2024-01-21T09:00", "2024-01-23T09:00"};
+    QTest::newRow("monthly second monday")
+        << newYork << "2024-01-08T09:00" << "RRULE:FREQ=MONTHLY;BYDAY=2MO;COUNT=3"
+        << "2024-01-01T00:00" << "2024-06-01T00:00" << QStringList()
+        << QStringList{"2024-01-08T09:00", "2024-02-12T09:00", "2024-03-11T09:00"};
+    QTest::newRow("monthly last friday")
+        << newYork << "2024-01-26T09:00" << "RRULE:FREQ=MONTHLY;BYDAY=-1FR;COUNT=3"
+        << "2024-01-01T00:00" << "2024-06-01T00:00" << QStringList()
+        << QStringList{"2024-01-26T09:00", "2024-02-23T09:00", "2024-03-29T09:00"};
+    QTest::newRow("yearly fourth thursday of november")
+        << newYork << "2024-11-28T12:00" << "RRULE:FREQ=YEARLY;BYMONTH=11;BYDAY=4TH"
+        << "2024-01-01T00:00" << "2026-01-01T00:00" << QStringList()
+        << QStringList{"2024-11-28T12:00", "2025-11-27T12:00"};
+    
+    // BYSETPOS
+    QTest::newRow("bysetpos last weekday")
+        << newYork << "2024-01-31T09:00" << "RRULE:FREQ=MONTHLY;BYDAY=MO,TU,WE,TH,FR;BYSETPOS=-1;COUNT=3"
+        << "2024-01-01T00:00" << "2024-06-01T00:00" << QStringList()
+        << QStringList{"2024-01-31T09:00", "2024-02-29T09:00", "2024-03-29T09:00"};
+    QTest::newRow("bysetpos first and last weekend day")
+        << newYork << "2024-06-01T10:00" << "RRULE:FREQ=MONTHLY;BYDAY=SA,SU;BYSETPOS=1,-1;COUNT=4"
+        << "2024-06-01T00:00" << "2024-09-01T00:00" << QStringList()
+        << QStringList{"2024-06-01T10:00", "2024-06-30T10:00", "2024-07-06T10:00", "2024-07-28T10:00"};
+    QTest::newRow("bysetpos out of range")
+        << newYork << "2024-01-01T09:00" << "RRULE:FREQ=WEEKLY;BYDAY=MO,TU;BYSETPOS=3,-3;COUNT=2"
+        << "2024-01-01T00:00" << "2024-02-01T00:00" << QStringList()
+        << QStringList();
+    QTest::newRow("bysetpos second monday or wednesday")
+        << newYork << "2024-01-01T09:00" << "RRULE:FREQ=MONTHLY;BYDAY=MO,WE;BYSETPOS=2;UNTIL=20240331T235959Z"
+        << "2024-01-01T00:00" << "2024-06-01T00:00" << QStringList()
+        << QStringList{"2024-01-03T09:00", "2024-02-07T09:00", "2024-03-06T09:00"};
+    
+    // EXDATE
+    QTest::newRow("exdate tzid")
+        << newYork << "2024-01-01T09:00"
+        << "RRULE:FREQ=DAILY;COUNT=4\nEXDATE;TZID=America/New_York:20240102T090000"
+        << "2024-01-01T00:00" << "2024-02-01T00:00" << QStringList()
+        << QStringList{"2024-01-01T09:00", "2024-01-03T09:00", "2024-01-04T09:00"};
+    QTest::newRow("exdate other zone")
+        << newYork << "2024-01-01T09:00"
+        << "RRULE:FREQ=DAILY;COUNT=4\nEXDATE;TZID=Asia/Taipei:20240103T220000"
+        << "2024-01-01T00:00" << "2024-02-01T00:00" << QStringList()
+        << QStringList{"2024-01-01T09:00", "2024-01-02T09:00", "2024-01-04T09:00"};
+    QTest::newRow("exdate utc list")
+        << newYork << "2024-01-01T09:00"
+        << "RRULE:FREQ=DAILY;COUNT=4\nEXDATE:20240101T140000Z,20240104T140000Z"
+        << "2024-01-01T00:00" << "2024-02-01T00:00" << QStringList()
+        << QStringList{"2024-01-02T09:00", "2024-01-03T09:00"};
+    QTest::newRow("exdate date only")
+        << newYork << "2024-01-01T09:00"
+        << "RRULE:FREQ=DAILY;COUNT=4\nEXDATE;VALUE=DATE:20240102"
+        << "2024-01-01T00:00" << "2024-02-01T00:00" << QStringList()
+        << QStringList{"2024-01-01T09:00", "2024-01-03T09:00", "2024-01-04T09:00"};
+    
+    // 例外實例
+    QTest::newRow("override moved")
+        << newYork << "2024-01-01T09:00" << "RRULE:FREQ=DAILY;COUNT=3"
+        << "2024-01-01T00:00" << "2024-02-01T00:00"
+        << QStringList{"2024-01-02T09:00>2024-01-02T15:00"}
+        << QStringList{"2024-01-01T09:00", "2024-01-02T15:00", "2024-01-03T09:00"};
+    QTest::newRow("override cancelled")
+        << newYork << "2024-01-01T09:00" << "RRULE:FREQ=DAILY;COUNT=3"
+        << "2024-01-01T00:00" << "2024-02-01T00:00"
+        << QStringList{"2024-01-02T09:00>cancelled"}
+        << QStringList{"2024-01-01T09:00", "2024-01-03T09:00"};
+    QTest::newRow("override moved out of range")
+        << newYork << "2024-01-01T09:00" << "RRULE:FREQ=DAILY;COUNT=3"
+        << "2024-01-01T00:00" << "2024-01-03T00:00"
+        << QStringList{"2024-01-02T09:00>2024-01-05T09:00"}
+        << QStringList{"2024-01-01T09:00"};
+    QTest::newRow("override moved into range")
+        << newYork << "2024-01-01T09:00" << "RRULE:FREQ=WEEKLY"
+        << "2024-03-01T00:00" << "2024-03-08T00:00"
+        << QStringList{"2024-01-08T09:00>2024-03-06T10:00"}
+        << QStringList{"2024-03-04T09:00", "2024-03-06T10:00"};
+    
+    // UNTIL 與時區：跨越日光節約時間後仍維持當地 09:00
+    QTest::newRow("until utc across dst start")
+        << newYork << "2024-03-08T09:00" << "RRULE:FREQ=DAILY;UNTIL=20240311T130000Z"
+        << "2024-03-01T00:00" << "2024-04-01T00:00" << QStringList()
+        << QStringList{"2024-03-08T09:00", "2024-03-09T09:00", "2024-03-10T09:00", "2024-03-11T09:00"};
+    QTest::newRow("until utc before last local occurrence")
+        << newYork << "2024-03-08T09:00" << "RRULE:FREQ=DAILY;UNTIL=20240311T125959Z"
+        << "2024-03-01T00:00" << "2024-04-01T00:00" << QStringList()
+        << QStringList{"2024-03-08T09:00", "2024-03-09T09:00", "2024-03-10T09:00"};
+    QTest::newRow("until local across dst end")
+        << newYork << "2024-10-27T09:00" << "RRULE:FREQ=WEEKLY;UNTIL=20241110T090000"
+        << "2024-10-01T00:00" << "2024-12-01T00:00" << QStringList()
+        << QStringList{"2024-10-27T09:00", "2024-11-03T09:00", "2024-11-10T09:00"};
+    QTest::newRow("until date only")
+        << QByteArray("Asia/Taipei") << "2024-01-01T23:30" << "RRULE:FREQ=DAILY;UNTIL=20240103"
+        << "2024-01-01T00:00" << "2024-02-01T00:00" << QStringList()
+        << QStringList{"2024-01-01T23:30", "2024-01-02T23:30", "2024-01-03T23:30"};
+}
+
+void TestRecurrenceExpander::expand() {
+    QFETCH(QByteArray, zoneId);
+    QFETCH(QString, dtstart);
+    QFETCH(QString, rule);
+    QFETCH(QString, rangeStart);
+    QFETCH(QString, rangeEnd);
+    QFETCH(QStringList, overrides);
+    QFETCH(QStringList, expected);
+    
+    const QTimeZone zone(zoneId);
+    QVERIFY(zone.isValid());
+    
+    CalendarEvent master;
+    master.id = "series";
+    master.title = "重複事件";
+    master.platform = Platform::Google;
+    master.ownerId = "user@example.com";
+    master.startTime = local(dtstart, zone);
+    master.endTime = master.startTime.addSecs(3600);
+    master.recurrenceRule = rule;
+    QVERIFY(master.isSeriesMaster());
+    
+    QList<CalendarEvent> exceptions;
+    for (const QString& entry : overrides) {
+        const QStringList parts = entry.split('>');
+        QCOMPARE(parts.size(), 2);
+        
+        CalendarEvent item = master;
+        item.recurrenceRule.clear();
+        item.seriesMasterId = master.id;
+        item.originalStartTime = local(parts[0], zone);
+        item.id = RecurrenceExpander::occurrenceId(master, item.originalStartTime);
+        if (parts[1] == "cancelled") {
+            item.isCancelled = true;
+        } else {
+            item.startTime = local(parts[1], zone);
+            item.endTime = item.startTime.addSecs(3600);
+        }
+        exceptions.append(item);
+    }
+    
+    RecurrenceExpander expander;
+    const QList<CalendarEvent> occurrences =
+        expander.expand(master, local(rangeStart, zone), local(rangeEnd, zone), exceptions);
+    
+    QStringList actual;
+    for (const CalendarEvent& occurrence : occurrences) {
+        actual << occurrence.startTime.toTimeZone(zone).toString("yyyy-MM-dd'T'HH:mm");
+        QCOMPARE(occurrence.seriesMasterId, master.id);
+    }
+    QCOMPARE(actual, expected);
+    
+    // 同一範圍再次展開會取自快取，結果必須相同
+    const QList<CalendarEvent> cached =
+        expander.expand(master, local(rangeStart, zone), local(rangeEnd, zone), exceptions);
+    QCOMPARE(cached.size(), occurrences.size());
+    for (int i = 0; i < cached.size(); ++i) {
+        QCOMPARE(cached[i].id, occurrences[i].id);
+        QCOMPARE(cached[i].startTime, occurrences[i].startTime);
+    }
+}
+
+void TestRecurrenceExpander::setPositionsFromParse() {
+    const RecurrenceRule rule = RecurrenceRule::parse(
+        "RRULE:FREQ=MONTHLY;BYDAY=MO,TU,WE,TH,FR;BYSETPOS=1,-2", QTimeZone::utc());
+    QVERIFY(rule.frequency == RecurrenceRule::Frequency::Monthly);
+    QCOMPARE(rule.byDay.size(), 5);
+    QCOMPARE(rule.bySetPos, (QList<int>{1, -2}));
+}
+
+QTEST_GUILESS_MAIN(TestRecurrenceExpander)
+#include "tst_recurrenceexpander.moc"